@@ -0,0 +1,15 @@
+/*
+*********************************************************************************************************
+* Module     : AVR/INTERRUPT.H (host)
+* Description: Host stand-in for <avr/interrupt.h>.
+*********************************************************************************************************
+*/
+
+#ifndef _HOST_AVR_INTERRUPT_H
+#define _HOST_AVR_INTERRUPT_H
+
+#define sei()
+#define cli()
+#define ISR(vector)       void vector (void)
+
+#endif // _HOST_AVR_INTERRUPT_H
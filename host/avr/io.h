@@ -0,0 +1,46 @@
+/*
+*********************************************************************************************************
+* Module     : AVR/IO.H (host)
+* Description: Host stand-in for <avr/io.h>.  The I/O registers are defined in HOST_IO.C so the AVR
+*              driver and demos compile and run on Linux.
+*
+*  PORTC carries the bit-banged DATA/CLK/LOAD pins, so every access to it goes through HostPortC().
+*  A C expression like "PORTC |= 0x04" calls HostPortC() once, before the read-modify-write; that
+*  call hands the previous write to the MAX7219 simulator.  HostIoSync() hands over the last one.
+*
+*  The ADC registers are plain variables: the conversion result in ADCW is whatever the host program
+*  last wrote there.
+*********************************************************************************************************
+*/
+
+#ifndef _HOST_AVR_IO_H
+#define _HOST_AVR_IO_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define _BV(bit)          (1 << (bit))
+
+extern volatile uint8_t PORTB, DDRB, DDRC, PORTD, DDRD;
+extern volatile uint8_t ADMUX, ADCSRA, DIDR0;
+extern volatile uint16_t ADCW;                        // written by the host program: the "sensor"
+
+volatile uint8_t *HostPortC (void);
+void HostIoSync (void);
+
+#define PORTC             (*HostPortC())
+
+#define REFS0             6                           // ADMUX
+#define ADEN              7                           // ADCSRA
+#define ADSC              6
+#define ADPS2             2
+#define ADPS1             1
+#define ADPS0             0
+
+#ifdef __cplusplus
+}
+#endif
+#endif // _HOST_AVR_IO_H
@@ -0,0 +1,16 @@
+/*
+*********************************************************************************************************
+* Module     : AVR/PGMSPACE.H (host)
+* Description: Host stand-in for <avr/pgmspace.h>.  Flash and RAM share one address space on the host.
+*********************************************************************************************************
+*/
+
+#ifndef _HOST_AVR_PGMSPACE_H
+#define _HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+
+#endif // _HOST_AVR_PGMSPACE_H
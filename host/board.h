@@ -0,0 +1,11 @@
+/*
+*********************************************************************************************************
+* Module     : BOARD.H (host)
+* Description: Host stand-in for the AVR32 Software Framework's board.h.
+*********************************************************************************************************
+*/
+
+#ifndef _HOST_BOARD_H
+#define _HOST_BOARD_H
+
+#endif // _HOST_BOARD_H
@@ -0,0 +1,13 @@
+/*
+*********************************************************************************************************
+* Module     : COMPILER.H (host)
+* Description: Host stand-in for the AVR32 Software Framework's compiler.h.
+*********************************************************************************************************
+*/
+
+#ifndef _HOST_COMPILER_H
+#define _HOST_COMPILER_H
+
+#include <stdint.h>
+
+#endif // _HOST_COMPILER_H
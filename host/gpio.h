@@ -0,0 +1,56 @@
+/*
+*********************************************************************************************************
+* Module     : GPIO.H (host)
+* Description: Host stand-in for the AVR32 Software Framework's GPIO driver.  The pin functions are
+*              defined in HOST_IO.C.
+*
+*  AVR32_GPIO_LOCAL goes through HostGpioLocal() the same way PORTC goes through HostPortC() in
+*  AVR/IO.H: every access hands the previous OVRS/OVRC write to the MAX7219 simulator.
+*********************************************************************************************************
+*/
+
+#ifndef _HOST_GPIO_H
+#define _HOST_GPIO_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AVR32_PIN_PA05    5
+#define AVR32_PIN_PA06    6
+#define AVR32_PIN_PA07    7
+
+typedef struct {
+  uint32_t pin;
+  uint32_t function;
+} gpio_map_t[];
+
+void gpio_enable_gpio_pin (uint32_t pin);
+void gpio_set_gpio_pin (uint32_t pin);
+void gpio_clr_gpio_pin (uint32_t pin);
+int  gpio_enable_module (const gpio_map_t gpiomap, uint32_t size);
+
+typedef struct {
+  uint32_t oders;                                     // output driver enable set
+  uint32_t oderc;                                     // output driver enable clear
+  uint32_t ovrs;                                      // output value set
+  uint32_t ovrc;                                      // output value clear
+} avr32_gpio_local_port_t;
+
+typedef struct {
+  avr32_gpio_local_port_t port[1];                    // port A only
+} avr32_gpio_local_t;
+
+volatile avr32_gpio_local_t *HostGpioLocal (void);
+
+#define AVR32_GPIO_LOCAL  (*HostGpioLocal())
+
+void gpio_local_init (void);
+void gpio_local_enable_pin_output_driver (uint32_t pin);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // _HOST_GPIO_H
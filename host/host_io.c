@@ -0,0 +1,190 @@
+/*
+*********************************************************************************************************
+* Module     : HOST_IO.C
+* Description: I/O registers and GPIO driver stand-ins for building the MAX7219 drivers on the host.
+*
+*  Writes to the pins the ports bit-bang (PC0/PC2/PC1 for MAX7219.C, PA05/PA06/PA07 for MAX7219_32.C)
+*  are passed to the MAX7219 simulator in MAX7219_SIM.C, so both drivers run unmodified against a
+*  model of the chip.  That includes the UC3L local bus registers (MAX7219_TRANSPORT_LOCALBUS) and,
+*  with MAX7219_TRANSPORT_PARALLEL, the DATA lines on PORTD, read at every PORTC write.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include <avr/io.h>
+#include "gpio.h"
+#include "max7219.h"                                  // MAX7219_TRANSPORT
+#include "max7219_sim.h"
+
+
+/*
+*********************************************************************************************************
+* Constants (must match the pin macros in MAX7219.C and MAX7219_32.C)
+*********************************************************************************************************
+*/
+#define HOST_DATA_BIT     0x01                        // PC0
+#define HOST_LOAD_BIT     0x02                        // PC1
+#define HOST_CLK_BIT      0x04                        // PC2
+
+#define HOST_DATA_PIN     AVR32_PIN_PA05
+#define HOST_CLK_PIN      AVR32_PIN_PA06
+#define HOST_LOAD_PIN     AVR32_PIN_PA07
+
+/*
+*********************************************************************************************************
+* Public Data
+*********************************************************************************************************
+*/
+volatile uint8_t PORTB, DDRB, DDRC, PORTD, DDRD;
+volatile uint8_t ADMUX, ADCSRA, DIDR0;
+volatile uint16_t ADCW;
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static volatile uint8_t HostPortCValue;               // PORTC contents
+static uint8_t  HostPortCPending;                     // a PORTC write has not been passed on yet
+static uint32_t HostGpioOut;                          // output level of PA00-PA31
+static uint32_t HostGpioEnabled;                      // pins handed to the GPIO module
+static volatile avr32_gpio_local_t HostGpioLocalRegs; // local bus GPIO registers
+static uint8_t  HostGpioLocalPending;                 // a local bus write has not been passed on yet
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void HostGpioPins (void);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* HostPortC()
+*
+* Description: Access PORTC.  Called once per "PORTC op= value" expression, before it writes, so the
+*              previous write is passed to the simulator here.
+* Arguments  : none
+* Returns    : address of the PORTC register
+*********************************************************************************************************
+*/
+volatile uint8_t *HostPortC (void) {
+  HostIoSync();
+  HostPortCPending = 1;
+  return &HostPortCValue;
+}
+
+
+/*
+*********************************************************************************************************
+* HostIoSync()
+*
+* Description: Pass a pending PORTC write to the simulator.  MAX7219_SIM.C calls this before it
+*              reports anything.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void HostIoSync (void) {
+  if (HostGpioLocalPending) {
+    volatile avr32_gpio_local_port_t *port = &HostGpioLocalRegs.port[0];
+    HostGpioLocalPending = 0;
+    if (port->ovrs | port->ovrc) {                    // OVRS/OVRC act on the bits written as 1
+      HostGpioOut = (HostGpioOut | port->ovrs) & ~port->ovrc;
+      HostGpioPins();
+    }
+    port->oders = port->oderc = port->ovrs = port->ovrc = 0;
+  }
+  if (!HostPortCPending)
+    return;
+  HostPortCPending = 0;
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+  MAX7219SimPins(PORTD,                               // PD0-PD7: one DATA line per chain
+#else
+  MAX7219SimPins((HostPortCValue & HOST_DATA_BIT) != 0,
+#endif
+                 (HostPortCValue & HOST_CLK_BIT)  != 0,
+                 (HostPortCValue & HOST_LOAD_BIT) != 0);
+}
+
+
+/*
+*********************************************************************************************************
+* HostGpioLocal()
+*
+* Description: Access the local bus GPIO registers.  Like HostPortC(), called before each write, so
+*              the previous write is passed to the simulator here.
+* Arguments  : none
+* Returns    : address of the local bus register block
+*********************************************************************************************************
+*/
+volatile avr32_gpio_local_t *HostGpioLocal (void) {
+  HostIoSync();
+  HostGpioLocalPending = 1;
+  return &HostGpioLocalRegs;
+}
+
+
+void gpio_enable_gpio_pin (uint32_t pin) {
+  HostGpioEnabled |= 1UL << (pin & 31);
+}
+
+
+void gpio_set_gpio_pin (uint32_t pin) {
+  HostGpioOut |= 1UL << (pin & 31);
+  HostGpioPins();
+}
+
+
+void gpio_clr_gpio_pin (uint32_t pin) {
+  HostGpioOut &= ~(1UL << (pin & 31));
+  HostGpioPins();
+}
+
+
+int gpio_enable_module (const gpio_map_t gpiomap, uint32_t size) {
+  (void)gpiomap;
+  (void)size;
+  return 0;
+}
+
+
+void gpio_local_init (void) {
+}
+
+
+void gpio_local_enable_pin_output_driver (uint32_t pin) {
+  (void)pin;
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* HostGpioPins()
+*
+* Description: Pass the current levels of the AVR32 DATA/CLK/LOAD pins to the simulator.
+*********************************************************************************************************
+*/
+static void HostGpioPins (void) {
+  MAX7219SimPins((HostGpioOut >> HOST_DATA_PIN) & 1,
+                 (HostGpioOut >> HOST_CLK_PIN)  & 1,
+                 (HostGpioOut >> HOST_LOAD_PIN) & 1);
+}
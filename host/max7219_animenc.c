@@ -0,0 +1,216 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_ANIMENC.C
+* Description: Encoder for the animations played by MAX7219_ANIM.C (host tool).
+*
+*  Reads frames, one per line, as eight hex bytes: the segment codes of digits 1-8 (or rows 0-7 of a
+*  matrix).  Each line is shown for one tick; identical lines in a row become one record held for as
+*  many ticks.  Empty lines and lines starting with '#' are skipped.  Writes the animation as a C
+*  array to stdout, and the size of the frames stored in full against the encoded size to stderr.
+*
+*    gcc -o max7219_animenc host/max7219_animenc.c
+*    max7219_animenc [-n name] [-k frames] [file] > anim.c
+*
+*  -n sets the array name (default "anim"), -k forces a keyframe every so many records so a damaged
+*  or skipped record repairs itself (default: only the first record and records that change every
+*  digit are keyframes).
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+
+/*
+*********************************************************************************************************
+* Constants (must match MAX7219_ANIM_x in max7219.h)
+*********************************************************************************************************
+*/
+#define ANIM_KEY          0x80
+#define ANIM_HOLD_MAX     126                         // 127 in a keyframe head would read as the end
+#define ANIM_END          0xff
+#define ANIM_LINE         256
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static uint8_t *EncOut;                               // encoded bytes
+static size_t   EncLength;
+static size_t   EncSize;
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void EncByte (uint8_t data);
+static int  EncParse (const char *line, uint8_t frame[8]);
+static void EncRecord (const uint8_t frame[8], const uint8_t shown[8], int key, unsigned long ticks);
+
+
+/*
+*********************************************************************************************************
+* main()
+*********************************************************************************************************
+*/
+int main (int argc, char **argv) {
+  const char *name = "anim";
+  unsigned long keyframes = 0, records = 0, frames = 0, ticks = 0, line_number = 0;
+  uint8_t frame[8], run[8], shown[8];
+  char line[ANIM_LINE];
+  FILE *in = stdin;
+  size_t i;
+  int opt;
+
+  for (opt = 1; opt < argc; opt++) {
+    if (strcmp(argv[opt], "-n") == 0 && opt + 1 < argc)
+      name = argv[++opt];
+    else if (strcmp(argv[opt], "-k") == 0 && opt + 1 < argc)
+      keyframes = strtoul(argv[++opt], NULL, 0);
+    else if (argv[opt][0] != '-' && in == stdin) {
+      if ((in = fopen(argv[opt], "r")) == NULL) {
+        perror(argv[opt]);
+        return 1;
+      }
+    } else {
+      fprintf(stderr, "usage: %s [-n name] [-k frames] [file]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  while (fgets(line, sizeof(line), in)) {
+    line_number++;
+    if (line[strspn(line, " \t\r\n")] == '\0' || line[0] == '#')
+      continue;
+    if (!EncParse(line, frame)) {
+      fprintf(stderr, "line %lu: expected 8 hex bytes\n", line_number);
+      return 1;
+    }
+    frames++;
+    if (ticks && memcmp(frame, run, 8) == 0) {        // same as the frame before: hold it longer
+      ticks++;
+      continue;
+    }
+    if (ticks) {
+      EncRecord(run, shown, records == 0 || (keyframes && records % keyframes == 0), ticks);
+      memcpy(shown, run, 8);
+      records++;
+    }
+    memcpy(run, frame, 8);
+    ticks = 1;
+  }
+  if (ticks) {
+    EncRecord(run, shown, records == 0 || (keyframes && records % keyframes == 0), ticks);
+    records++;
+  }
+  EncByte(ANIM_END);
+
+  printf("// %lu frames, %lu records: %lu bytes as full frames, %lu bytes encoded\n",
+         frames, records, frames * 8, (unsigned long)EncLength);
+  printf("const uint8_t %s[%lu] MAX7219_ANIM_ATTR = {", name, (unsigned long)EncLength);
+  for (i = 0; i < EncLength; i++)
+    printf("%s0x%02x%s", (i % 12) ? " " : "\n  ", EncOut[i], (i + 1 < EncLength) ? "," : "");
+  printf("\n};\n");
+
+  fprintf(stderr, "%s: %lu frames, %lu records, %lu -> %lu bytes, ratio %.2f\n", name, frames,
+          records, frames * 8, (unsigned long)EncLength,
+          EncLength ? (double)(frames * 8) / EncLength : 0.0);
+  return 0;
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* EncRecord()
+*
+* Description: Append the record(s) for one frame held for a number of ticks: a keyframe, or a delta
+*              of the digits that differ from the frame shown before; holds longer than one record
+*              allows continue in empty deltas.
+*********************************************************************************************************
+*/
+static void EncRecord (const uint8_t frame[8], const uint8_t shown[8], int key, unsigned long ticks) {
+  unsigned long hold = (ticks > ANIM_HOLD_MAX) ? ANIM_HOLD_MAX : ticks;
+  uint8_t mask = 0;
+  int digit;
+
+  for (digit = 0; digit < 8; digit++)
+    if (key || frame[digit] != shown[digit])
+      mask |= 1 << digit;
+
+  if (mask == 0xff) {                                 // 9 bytes, a full delta would take 10
+    EncByte(ANIM_KEY | hold);
+  } else {
+    EncByte(hold);
+    EncByte(mask);
+  }
+  for (digit = 0; digit < 8; digit++)
+    if (mask & (1 << digit))
+      EncByte(frame[digit]);
+
+  for (ticks -= hold; ticks; ticks -= hold) {
+    hold = (ticks > ANIM_HOLD_MAX) ? ANIM_HOLD_MAX : ticks;
+    EncByte(hold);
+    EncByte(0);
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* EncParse()
+*
+* Description: Read eight hex bytes from a line.  Returns 1 on success.
+*********************************************************************************************************
+*/
+static int EncParse (const char *line, uint8_t frame[8]) {
+  unsigned long value;
+  char *end;
+  int digit;
+
+  for (digit = 0; digit < 8; digit++) {
+    value = strtoul(line, &end, 16);
+    if (end == line || value > 0xff)
+      return 0;
+    frame[digit] = (uint8_t)value;
+    line = end;
+  }
+  return line[strspn(line, " \t\r\n")] == '\0';
+}
+
+
+/*
+*********************************************************************************************************
+* EncByte()
+*
+* Description: Append one byte to the output.
+*********************************************************************************************************
+*/
+static void EncByte (uint8_t data) {
+  if (EncLength == EncSize) {
+    EncSize = EncSize ? 2 * EncSize : 256;
+    if ((EncOut = realloc(EncOut, EncSize)) == NULL) {
+      perror("realloc");
+      exit(1);
+    }
+  }
+  EncOut[EncLength++] = data;
+}
@@ -0,0 +1,492 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_BENCH.C
+* Description: Bus cost benchmark for the MAX7219 drivers (host build).
+*
+*  Runs every public display call and the demos against the simulated bus and prints, per call,
+*  the pin writes, CLK edges, LOAD frames and register writes it cost, plus an estimate of MCU cycles
+*  and microseconds.  Output is CSV on stdout, one row per case, so runs can be diffed or compared
+*  across transports.  A second table gives the CPU duty cycle of the demos, which sleep between the
+*  ticks of MAX7219_SCHED.C.
+*
+*    gcc -Ihost -I. -o max7219_bench max7219.c max7219_chain.c max7219_shadow.c max7219_font.c \
+*        max7219_text.c max7219_matrix.c max7219_scroll.c max7219_queue.c max7219_buffer.c \
+*        max7219_sched.c max7219_fade.c max7219_ambient.c max7219_anim.c max7219_stats.c \
+*        host/host_io.c host/max7219_sim.c host/max7219_mock.c host/max7219_capture.c \
+*        host/max7219_bench.c
+*
+*  Use max7219_32.c and -DBENCH_AVR32 for the UC3L port, -DMAX7219_TRANSPORT=MAX7219_TRANSPORT_MOCK
+*  to count a hardware SPI transport instead of the bit-banged pins, and -DMAX7219_CHAIN_MAX=n for a
+*  chain of n chips.  With max7219_32.c, -DMAX7219_TRANSPORT=MAX7219_TRANSPORT_LOCALBUS measures the
+*  local bus back end; with max7219.c, -DMAX7219_TRANSPORT=MAX7219_TRANSPORT_PARALLEL the chain split
+*  into MAX7219_PARALLEL_LINES chains clocked together (clocks then counts CLK pulses, not bits).
+*
+*  The cycle figures are a model, not a measurement: each counted event is weighted with the cost of
+*  the code that produces it on the target (see the BENCH_CYC_x constants).
+*
+*  max7219_bench -c prefix also writes the bus traffic of every case to a trace file, prefix plus
+*  the case name with '/' as '-' plus ".m7t" (see MAX7219_CAPTURE.H), setup and initialisation
+*  included.  host/max7219_replay.c reports a trace or compares two, e.g. the same case before and
+*  after a change, or "redraw-direct.m7t" against "redraw-MAX7219Commit.m7t".
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include <stdio.h>
+#include <string.h>
+#include <avr/io.h>                                   // ADCW: the light sensor of the ambient case
+#include "max7219.h"
+#include "max7219_mock.h"
+#include "max7219_sim.h"
+#include "max7219_capture.h"
+
+
+/*
+*********************************************************************************************************
+* Constants
+*
+*  Cycle model per counted event.  BENCH_CYC_PIN is one DATA/CLK/LOAD write, BENCH_CYC_BIT the loop
+*  and mask work per bit besides the pin writes, BENCH_CYC_BYTE one MAX7219SendByte() call (for the
+*  hardware transport: the whole byte on the wire plus polling), BENCH_CYC_FRAME the frame set-up and
+*  latch calls.  BENCH_CYC_TICK is the fixed cost of one MAX7219SchedRun() pass.
+*********************************************************************************************************
+*/
+#ifdef BENCH_AVR32
+#define BENCH_MCU         "uc3l"
+#define BENCH_MHZ         25                          // main_32.c runs the CPU at 25 MHz
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_LOCALBUS
+#define BENCH_CYC_PIN     1                           // single cycle store to OVRS/OVRC
+#define BENCH_CYC_BIT     4                           // two hold nops, shift and mask of the unrolled bit
+#define BENCH_CYC_FRAME   12
+#define BENCH_CYC_BYTE    4                           // half a MAX7219SendWord() call
+#else
+#define BENCH_CYC_PIN     15                          // gpio_set_gpio_pin() call through the PBA
+#define BENCH_CYC_BIT     10
+#define BENCH_CYC_FRAME   40
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+#define BENCH_CYC_BYTE    30                          // 8 bits at fPBA/3 plus TDRE polling
+#else
+#define BENCH_CYC_BYTE    8
+#endif
+#endif
+#else
+#define BENCH_MCU         "atmega"
+#define BENCH_MHZ         16
+#define BENCH_CYC_PIN     2                           // sbi/cbi on PORTC
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+#define BENCH_CYC_BIT     (3 + 4 * MAX7219_PARALLEL_LINES)  // PORTD write and the transpose
+#else
+#define BENCH_CYC_BIT     21                          // variable shift for the mask dominates
+#endif
+#define BENCH_CYC_FRAME   20
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+#define BENCH_CYC_BYTE    28                          // 16 cycles on the wire at fosc/2 plus SPIF polling
+#else
+#define BENCH_CYC_BYTE    8
+#endif
+#endif
+
+#ifdef BENCH_AVR32
+#define BENCH_CYC_TICK    80                          // TC interrupt, wake-up and one scheduler pass
+#else
+#define BENCH_CYC_TICK    60
+#endif
+#define BENCH_TICK_HZ     50                          // scheduler rate of the demos
+
+// Bus clock of the trace time stamps: one bit costs BENCH_CYC_BIT and three pin writes (two CLK
+// writes in parallel), or an eighth of BENCH_CYC_BYTE on the hardware transport.
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+#define BENCH_BUS_HZ      (BENCH_MHZ * 8000000UL / BENCH_CYC_BYTE)
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+#define BENCH_BUS_HZ      (BENCH_MHZ * 1000000UL / (BENCH_CYC_BIT + 2 * BENCH_CYC_PIN))
+#else
+#define BENCH_BUS_HZ      (BENCH_MHZ * 1000000UL / (BENCH_CYC_BIT + 3 * BENCH_CYC_PIN))
+#endif
+
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+#define BENCH_TRANSPORT   "spi"
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_LOCALBUS
+#define BENCH_TRANSPORT   "localbus"
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+#define BENCH_TRANSPORT   "parallel"
+#else
+#define BENCH_TRANSPORT   "bitbang"
+#endif
+
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+#define BENCH_LINES       MAX7219_PARALLEL_LINES      // DATA lines the chain is split into
+#else
+#define BENCH_LINES       1
+#endif
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+struct bench_count {
+  unsigned long pins;                                 // DATA/CLK/LOAD writes
+  unsigned long clocks;                               // CLK rising edges
+  unsigned long bytes;                                // bytes shifted
+  unsigned long frames;                               // LOAD frames
+  unsigned long writes;                               // registers latched
+};
+
+static unsigned char BenchDigit;                      // rolling content for the "changed" cases
+static const char *BenchCapture;                      // -c: trace file prefix, 0 = no traces
+
+// One segment walking around digits 1-4, 24 frames (max7219_animenc -n BenchSnake): 82 bytes against
+// 192 as full frames.
+static const uint8_t BenchSnake[82] MAX7219_ANIM_ATTR = {
+  0x81, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x20,
+  0x01, 0x01, 0x10, 0x01, 0x01, 0x08, 0x01, 0x01, 0x04, 0x01, 0x01, 0x02,
+  0x01, 0x03, 0x00, 0x40, 0x01, 0x02, 0x20, 0x01, 0x02, 0x10, 0x01, 0x02,
+  0x08, 0x01, 0x02, 0x04, 0x01, 0x02, 0x02, 0x01, 0x06, 0x00, 0x40, 0x01,
+  0x04, 0x20, 0x01, 0x04, 0x10, 0x01, 0x04, 0x08, 0x01, 0x04, 0x04, 0x01,
+  0x04, 0x02, 0x01, 0x0c, 0x00, 0x40, 0x01, 0x08, 0x20, 0x01, 0x08, 0x10,
+  0x01, 0x08, 0x08, 0x01, 0x08, 0x04, 0x01, 0x08, 0x02, 0xff
+};
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void BenchReset (void);
+static void BenchRead (struct bench_count *count);
+static double BenchRun (const char *name, void (*setup)(unsigned long), void (*body)(unsigned long),
+                        unsigned long calls);
+static void BenchDuty (const char *name, double cycles);
+static void BenchCaptureOpen (const char *name);
+
+
+// ..................................... Benchmark Cases ................................................
+
+static void SetupNone (unsigned long i)      { (void)i; }
+
+static void SetupEights (unsigned long i) {
+  unsigned char d;
+  (void)i;
+  for (d = 1; d <= 8; d++)
+    MAX7219DisplayChar(d, '8', 0x80);
+  MAX7219Flush();
+}
+
+static void SetupBlankDigit (unsigned long i) { (void)i; MAX7219DisplayChar(1, ' ', 0); MAX7219Flush(); }
+static void SetupDigitA (unsigned long i)     { (void)i; MAX7219DisplayChar(1, 'A', 0x80); MAX7219Flush(); }
+static void SetupDim (unsigned long i)        { (void)i; MAX7219SetBrightness(3); MAX7219Flush(); }
+static void SetupPattern (unsigned long i)    { if (i == 0) MAX7219MatrixSet(0, 0x00000000000000ffULL); }
+static void SetupScroll (unsigned long i)     { if (i == 0) MAX7219ScrollStart(1, 8, "HELLO 1234.5", 1); }
+static void SetupNoDots (unsigned long i)     { (void)i; MAX7219DisplayL123(0); MAX7219Flush(); }
+
+static void BodyInit (unsigned long i)       { (void)i; MAX7219Init(); }
+static void BodyWrite (unsigned long i)      { MAX7219Write(REG_DIGIT0 + (i & 7), (unsigned char)i); }
+static void BodyWriteAll (unsigned long i)   { MAX7219WriteAll(REG_DIGIT0 + (i & 7), (unsigned char)i); }
+static void BodyClear (unsigned long i)      { (void)i; MAX7219Clear(); MAX7219Flush(); }
+static void BodyChar (unsigned long i)       { (void)i; MAX7219DisplayChar(1, 'A', 0x80); MAX7219Flush(); }
+static void BodyBright (unsigned long i)     { (void)i; MAX7219SetBrightness(15); MAX7219Flush(); }
+static void BodyL123 (unsigned long i)       { (void)i; MAX7219DisplayL123(L1 | L2 | L3); MAX7219Flush(); }
+static void BodyInt (unsigned long i)        { MAX7219DisplayInt(1, 8, (int32_t)i); MAX7219Flush(); }
+static void BodyMatrix (unsigned long i)     { (void)i; MAX7219MatrixRotate(0, 1); MAX7219MatrixShow(); MAX7219Flush(); }
+// One scroll step as the scheduler runs it: the tick, then the flush.
+static void BodyScroll (unsigned long i) {
+  (void)i;
+  MAX7219ScrollTick();
+  MAX7219FlushAsync(0);
+  while (MAX7219MockIrq())
+    ;
+}
+// Brightness set twice, clear and redraw: every write goes out without a transaction.
+static void BodyRedraw (unsigned long i) {
+  (void)i;
+  MAX7219Write(REG_INTENSITY, 3);
+  MAX7219Write(REG_INTENSITY, 15);
+  MAX7219Clear();
+  MAX7219DisplayString(1, "12 34");
+  MAX7219Flush();
+}
+
+static void BodyCommit (unsigned long i)     { MAX7219Begin(); BodyRedraw(i); MAX7219Commit(); }
+// Counter drawn into the back buffer digit by digit, then shown in one burst.
+static void BodyBuffer (unsigned long i) {
+  unsigned char d;
+  for (d = 8; d >= 1; d--, i /= 10)
+    MAX7219BufferSet(0, d, (uint8_t)(0x30 + i % 10));
+  MAX7219BufferCommit();
+  while (MAX7219MockIrq())
+    ;
+}
+
+static void BodyTime (unsigned long i)       { MAX7219DisplayTime(i / 60, i % 60, i & 1); MAX7219Flush(); }
+
+static void BodyRefresh (unsigned long i) {
+  unsigned char d;
+  (void)i;
+  BenchDigit = (BenchDigit == '9') ? '0' : BenchDigit + 1;  // every digit changes every pass
+  for (d = 1; d <= 8; d++)
+    MAX7219DisplayChar(d, BenchDigit, 0);
+  MAX7219Flush();
+}
+
+// The demos in main_32.c and max7219_simple_demo.c: the digits are drawn once, a task fades the
+// brightness over 1 second every 2 seconds and MAX7219SchedRun() runs one tick per call.
+static void BenchBlink (void) {
+  static const unsigned char brightness_levels[2] = {3, 15};
+  static unsigned char index;
+  index ^= 1;
+  MAX7219Fade(brightness_levels[index], BENCH_TICK_HZ);
+}
+
+static void SetupDemo (unsigned long i) {
+  if (i != 0)
+    return;
+  MAX7219DisplayChar(1, 'A', 0x80);
+  MAX7219DisplayChar(2, 'B', 0x80);
+  MAX7219DisplayL123(L1 | L2 | L3);
+  MAX7219DisplayChar(4, 'C', 0x80);
+  MAX7219DisplayChar(5, 'D', 0x80);
+  MAX7219Fade(3, 0);
+  MAX7219SchedRun();                                  // first tick sends the drawing, not measured
+  while (MAX7219MockIrq())
+    ;
+}
+
+static void SetupFade (unsigned long i) {
+  if (i != 0)
+    return;
+  MAX7219Fade(0, 0);                                  // the whole range: 15 intensity writes
+  SetupEights(i);
+  MAX7219Fade(15, BENCH_TICK_HZ);
+}
+
+static void BodyFade (unsigned long i)      { (void)i; MAX7219FadeTick(); MAX7219Flush(); }
+// Light sensor: dark, a ramp to bright and bright again, with +-40 counts of noise on every reading.
+static void SetupAmbient (unsigned long i) {
+  if (i != 0)
+    return;
+  SetupEights(i);
+  ADCW = 100;
+  MAX7219AmbientInit(1, 15);
+}
+
+static void BodyAmbient (unsigned long i) {
+  static uint32_t seed = 1;
+  long level = (i < 1000) ? 100 : (i < 2000) ? 100 + (long)(i - 1000) * 4 / 5 : 900;
+  seed = seed * 1103515245UL + 12345;
+  ADCW = (uint16_t)(level + (long)((seed >> 16) % 81) - 40);
+  MAX7219AmbientTick();
+  MAX7219Flush();
+}
+
+static void SetupAnim (unsigned long i) {
+  if (i == 0)
+    MAX7219AnimStart(BenchSnake, 1);
+  while (MAX7219MockIrq())                            // the first frame, sent by MAX7219AnimStart()
+    ;
+}
+static void BodyAnim (unsigned long i)      { (void)i; MAX7219AnimTick(); MAX7219Flush(); }
+static void BodySched (unsigned long i) {
+  (void)i;
+  MAX7219SchedRun();
+  while (MAX7219MockIrq())
+    ;
+  MAX7219CaptureIdle(1000000UL / BENCH_TICK_HZ);      // asleep until the next tick
+}
+
+
+/*
+*********************************************************************************************************
+* main()
+*********************************************************************************************************
+*/
+int main (int argc, char **argv) {
+  double demo;
+
+  if (argc == 3 && strcmp(argv[1], "-c") == 0) {
+    BenchCapture = argv[2];
+  } else if (argc != 1) {
+    fprintf(stderr, "usage: %s [-c trace-prefix]\n", argv[0]);
+    return 2;
+  }
+
+  printf("mcu,transport,chain,case,calls,pin_writes,clock_edges,load_frames,reg_writes,est_cycles,est_us\n");
+
+  BenchRun("MAX7219Init",                  SetupNone,       BodyInit,       1);
+  BenchRun("MAX7219Write",                 SetupNone,       BodyWrite,      64);
+  BenchRun("MAX7219WriteAll",              SetupNone,       BodyWriteAll,   64);
+  BenchRun("MAX7219Clear",                 SetupEights,     BodyClear,      16);
+  BenchRun("MAX7219Clear/unchanged",       SetupNone,       BodyClear,      16);
+  BenchRun("MAX7219DisplayChar",           SetupBlankDigit, BodyChar,       16);
+  BenchRun("MAX7219DisplayChar/unchanged", SetupDigitA,     BodyChar,       16);
+  BenchRun("MAX7219SetBrightness",         SetupDim,        BodyBright,     16);
+  BenchRun("MAX7219SetBrightness/unchanged", SetupNone,     BodyBright,     16);
+  BenchRun("MAX7219DisplayL123",           SetupNoDots,     BodyL123,       16);
+  BenchRun("MAX7219DisplayInt/counter",    SetupNone,       BodyInt,        1000);
+  BenchRun("MAX7219DisplayTime/minutes",   SetupNone,       BodyTime,       1440);
+  BenchRun("MAX7219MatrixShow/rotate",     SetupPattern,    BodyMatrix,     16);
+  BenchRun("MAX7219ScrollTick/step",       SetupScroll,     BodyScroll,     100);
+  BenchRun("redraw/direct",                SetupNone,       BodyRedraw,     16);
+  BenchRun("redraw/MAX7219Commit",         SetupNone,       BodyCommit,     16);
+  BenchRun("redraw/MAX7219BufferCommit",   SetupNone,       BodyBuffer,     1000);
+  BenchRun("MAX7219FadeTick/1s",           SetupFade,       BodyFade,       BENCH_TICK_HZ);
+  BenchRun("MAX7219AmbientTick/noisy",     SetupAmbient,    BodyAmbient,    3000);
+  BenchRun("MAX7219AnimTick/snake",        SetupAnim,       BodyAnim,       96);
+  BenchRun("refresh/8-digits",             SetupNone,       BodyRefresh,    100);
+
+  MAX7219SchedAdd(BenchBlink, 2 * BENCH_TICK_HZ);
+  MAX7219SchedAdd(MAX7219FadeTick, 1);
+  MAX7219SchedInit(BENCH_TICK_HZ);
+  demo = BenchRun("MAX7219SchedRun/demo",  SetupDemo,       BodySched,      10 * BENCH_TICK_HZ);
+
+  printf("\nmcu,transport,chain,case,tick_hz,busy_cycles,tick_cycles,duty_pct\n");
+  BenchDuty("demo", demo);
+  MAX7219CaptureClose();
+  return 0;
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* BenchReset()
+*
+* Description: Start from power-up chips and zeroed counters.
+*********************************************************************************************************
+*/
+static void BenchReset (void) {
+  MAX7219SimReset(MAX7219_CHAIN_MAX);
+  MAX7219SimSetLines(BENCH_LINES);
+  MAX7219MockReset(MAX7219_CHAIN_MAX);
+}
+
+
+/*
+*********************************************************************************************************
+* BenchRead()
+*
+* Description: Read the bus counters of whichever back end the driver is built against.
+*********************************************************************************************************
+*/
+static void BenchRead (struct bench_count *count) {
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+  count->pins   = 0;                                  // no pins: the peripheral shifts
+  count->bytes  = MAX7219MockBytes();
+  count->clocks = count->bytes * 8;
+  count->frames = MAX7219MockFrames();
+  count->writes = MAX7219MockWrites();
+#else
+  count->pins   = MAX7219SimPinWrites();
+  count->clocks = MAX7219SimClocks();
+  count->bytes  = count->clocks / 8;
+  count->frames = MAX7219SimFrames();
+  count->writes = MAX7219SimWrites();
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+* BenchRun()
+*
+* Description: Run one case and print its CSV row.  setup() runs before every call and is not
+*              counted; the row reports the average cost of one body() call.  MAX7219Init() always
+*              resends every register, so the Init case is measured after a first Init as well.
+* Arguments  : name = case name
+*              setup = unmeasured preparation, called with the iteration number
+*              body = measured call, called with the iteration number
+*              calls = number of iterations
+* Returns    : estimated cycles of one body() call
+*********************************************************************************************************
+*/
+static double BenchRun (const char *name, void (*setup)(unsigned long), void (*body)(unsigned long),
+                        unsigned long calls) {
+  struct bench_count before, after, total = {0, 0, 0, 0, 0};
+  unsigned long i;
+  double cycles;
+
+  BenchReset();
+  BenchCaptureOpen(name);
+  MAX7219Init();                                      // every case starts from an initialised display
+  BenchDigit = '0';
+
+  for (i = 0; i < calls; i++) {
+    setup(i);
+    BenchRead(&before);
+    body(i);
+    BenchRead(&after);
+    total.pins   += after.pins   - before.pins;
+    total.clocks += after.clocks - before.clocks;
+    total.bytes  += after.bytes  - before.bytes;
+    total.frames += after.frames - before.frames;
+    total.writes += after.writes - before.writes;
+  }
+
+  cycles = (double)total.pins   * BENCH_CYC_PIN +
+           (double)total.clocks * BENCH_CYC_BIT * (MAX7219_TRANSPORT != MAX7219_TRANSPORT_MOCK) +
+           (double)total.bytes  * BENCH_CYC_BYTE +
+           (double)total.frames * BENCH_CYC_FRAME;
+  cycles /= calls;
+
+  printf("%s,%s,%d,%s,%lu,%.2f,%.2f,%.3f,%.3f,%.0f,%.2f\n",
+         BENCH_MCU, BENCH_TRANSPORT, MAX7219_CHAIN_MAX, name, calls,
+         (double)total.pins / calls, (double)total.clocks / calls,
+         (double)total.frames / calls, (double)total.writes / calls,
+         cycles, cycles / BENCH_MHZ);
+  return cycles;
+}
+
+
+/*
+*********************************************************************************************************
+* BenchDuty()
+*
+* Description: Print the CPU duty cycle of a scheduled loop: the cycles of one tick's work plus the
+*              scheduler's own, against the cycles between two ticks.  The CPU sleeps for the rest.
+* Arguments  : name = case name
+*              cycles = average cycles of one MAX7219SchedRun() call, from BenchRun()
+*********************************************************************************************************
+*/
+static void BenchDuty (const char *name, double cycles) {
+  double busy = cycles + BENCH_CYC_TICK;
+  double tick = (double)BENCH_MHZ * 1000000.0 / BENCH_TICK_HZ;
+
+  printf("%s,%s,%d,%s,%d,%.0f,%.0f,%.3f\n",
+         BENCH_MCU, BENCH_TRANSPORT, MAX7219_CHAIN_MAX, name, BENCH_TICK_HZ, busy, tick,
+         100.0 * busy / tick);
+}
+
+
+/*
+*********************************************************************************************************
+* BenchCaptureOpen()
+*
+* Description: With -c, start the trace file of a case.
+* Arguments  : name = case name
+*********************************************************************************************************
+*/
+static void BenchCaptureOpen (const char *name) {
+  char path[256];
+  char *p;
+
+  if (BenchCapture == NULL)
+    return;
+  snprintf(path, sizeof(path), "%s%s.m7t", BenchCapture, name);
+  for (p = path + strlen(BenchCapture); *p; p++)
+    if (*p == '/')
+      *p = '-';
+  if (!MAX7219CaptureOpen(path, MAX7219_CHAIN_MAX, BENCH_LINES, BENCH_BUS_HZ))
+    perror(path);
+}
@@ -0,0 +1,159 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_CAPTURE.C
+* Description: Bus trace capture for the host simulators (see MAX7219_CAPTURE.H).
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include <stdio.h>
+#include "max7219_capture.h"
+
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static FILE *CaptureFile;                             // 0 = not capturing
+static unsigned long CaptureBusHz;                    // bus clock periods per second
+static unsigned long long CaptureClock;               // bus clock periods since the last frame
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void CaptureLong (unsigned long value);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219CaptureOpen()
+*
+* Description: Start a trace file, replacing one that is open.
+* Arguments  : path = file to write
+*              chips = chain length, recorded for the replay
+*              lines = DATA lines the chain is split into (MAX7219_TRANSPORT_PARALLEL), else 1
+*              bus_hz = bus clock the time stamps are counted in
+* Returns    : 1 = capturing, 0 = the file could not be created
+*********************************************************************************************************
+*/
+unsigned char MAX7219CaptureOpen (const char *path, unsigned char chips, unsigned char lines,
+                                  unsigned long bus_hz) {
+  MAX7219CaptureClose();
+  if ((CaptureFile = fopen(path, "wb")) == NULL)
+    return 0;
+  CaptureBusHz = bus_hz ? bus_hz : 1;
+  CaptureClock = 0;
+  fputs(CAPTURE_MAGIC, CaptureFile);
+  fputc(CAPTURE_VERSION, CaptureFile);
+  fputc(chips, CaptureFile);
+  fputc(lines, CaptureFile);
+  fputc(0, CaptureFile);
+  CaptureLong(CaptureBusHz);
+  return 1;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219CaptureClose()
+*
+* Description: Finish the trace file.  Time spent idle after the last frame is not recorded.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219CaptureClose (void) {
+  if (CaptureFile == NULL)
+    return;
+  fclose(CaptureFile);
+  CaptureFile = NULL;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219CaptureIdle()
+*
+* Description: Advance the trace clock by time the application spends away from the bus.
+* Arguments  : us = microseconds
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219CaptureIdle (unsigned long us) {
+  CaptureClock += (unsigned long long)us * CaptureBusHz / 1000000UL;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219CaptureFrame()
+*
+* Description: Record a LOAD frame.  Called by the simulators on the LOAD rising edge.
+* Arguments  : chips = chips in the modelled chain
+*              shift = each chip's 16-bit shift register, chip 0 first
+*              clocks = CLK pulses since the last LOAD
+*              bad = 1 if that was not 16 per chip (per chip of a chain, with several DATA lines)
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219CaptureFrame (unsigned char chips, const unsigned int *shift, unsigned long clocks,
+                          unsigned char bad) {
+  unsigned long long delta;
+  unsigned char chip, count = 0;
+
+  if (CaptureFile == NULL)
+    return;
+  for (chip = 0; chip < chips; chip++)
+    if (shift[chip] & 0x0f00)                         // address 0x00 is the no-op
+      count++;
+
+  delta = CaptureClock + clocks;
+  CaptureClock = 0;
+  while (delta >= 0x80) {                             // varint, low 7 bits first
+    fputc((int)(delta & 0x7f) | 0x80, CaptureFile);
+    delta >>= 7;
+  }
+  fputc((int)delta, CaptureFile);
+  fputc(count | (bad ? CAPTURE_BAD : 0), CaptureFile);
+  for (chip = 0; chip < chips; chip++) {
+    if (shift[chip] & 0x0f00) {
+      fputc(chip, CaptureFile);
+      fputc((shift[chip] >> 8) & 0x0f, CaptureFile);
+      fputc(shift[chip] & 0xff, CaptureFile);
+    }
+  }
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* CaptureLong()
+*
+* Description: Write a 32-bit value, least significant byte first.
+*********************************************************************************************************
+*/
+static void CaptureLong (unsigned long value) {
+  unsigned char i;
+  for (i = 0; i < 4; i++, value >>= 8)
+    fputc((int)(value & 0xff), CaptureFile);
+}
@@ -0,0 +1,49 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_CAPTURE.H
+* Description: Bus trace capture for the host simulators (MAX7219_SIM.C and MAX7219_MOCK.C).
+*
+*  Once MAX7219CaptureOpen() has named a file, every LOAD frame the modelled chain latches is
+*  appended to it, whichever back end the driver is built against.  The trace is replayed and
+*  compared offline by host/max7219_replay.c.
+*
+*  Time in the trace is counted in bus clock periods: each frame advances the clock by the bits it
+*  clocked, and MAX7219CaptureIdle() by the time the application spends away from the bus (e.g. the
+*  sleep between scheduler ticks).  bus_hz, stored in the header, turns periods into seconds.
+*
+*  File format, little-endian:
+*
+*    header   "M7TR", version (1), chain length, DATA lines the chain is split into (0 = 1),
+*             1 byte reserved, bus_hz (4 bytes)
+*    frame    time since the previous frame as a base-128 varint (low 7 bits first, bit 7 = more),
+*             count | 0x80 if the frame was not 16 bits per chip, then count x (chip, register, data)
+*
+*  A frame lists only the words that were not no-ops; chip 0 is the chip nearest the MCU.
+*********************************************************************************************************
+*/
+
+#ifndef _MAX7219_CAPTURE_H
+#define _MAX7219_CAPTURE_H
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define CAPTURE_MAGIC     "M7TR"
+#define CAPTURE_VERSION   1
+#define CAPTURE_HEADER    12                          // bytes before the first frame
+#define CAPTURE_BAD       0x80                        // count byte: clock count of the frame was wrong
+
+/*
+*********************************************************************************************************
+* Public Function Prototypes
+*********************************************************************************************************
+*/
+unsigned char MAX7219CaptureOpen (const char *path, unsigned char chips, unsigned char lines,
+                                  unsigned long bus_hz);
+void MAX7219CaptureClose (void);
+void MAX7219CaptureIdle (unsigned long us);
+void MAX7219CaptureFrame (unsigned char chips, const unsigned int *shift, unsigned long clocks,
+                          unsigned char bad);
+#endif // _MAX7219_CAPTURE_H
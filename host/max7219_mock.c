@@ -0,0 +1,193 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_MOCK.C
+* Description: Host mock transport for the MAX7219 drivers (see MAX7219_MOCK.H).
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include <string.h>
+#include "max7219.h"
+#include "max7219_mock.h"
+#include "max7219_capture.h"
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define MOCK_CHIPS        16                          // longest chain the mock can model
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static unsigned char MockChain = 1;                   // chips in the modelled chain
+static unsigned int  MockShift[MOCK_CHIPS];           // each chip's 16-bit shift register
+static unsigned char MockLoad = 1;                    // current LOAD level
+static unsigned char MockRegs[MOCK_CHIPS][16];        // latched register contents
+static unsigned long MockBytes;                       // bytes shifted in
+static unsigned long MockLatchBytes;                  // MockBytes at the last LOAD rising edge
+static unsigned long MockFrames;                      // LOAD rising edges
+static unsigned long MockWrites;                      // words latched into a register other than no-op
+static const unsigned char *MockAsyncNext;            // next byte of an interrupt driven frame
+static unsigned char MockAsyncLeft;                   // bytes still to go
+static unsigned char MockAsyncActive;                 // a "transfer complete" interrupt is pending
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219MockReset()
+*
+* Description: Clear the modelled chips and the counters.
+* Arguments  : chips = number of chips in the modelled chain (1-16)
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MockReset (unsigned char chips) {
+  MockChain  = (chips < 1) ? 1 : (chips > MOCK_CHIPS) ? MOCK_CHIPS : chips;
+  MockLoad   = 1;
+  MockBytes  = 0;
+  MockLatchBytes = 0;
+  MockFrames = 0;
+  MockWrites = 0;
+  MockAsyncActive = 0;
+  memset(MockShift, 0, sizeof(MockShift));
+  memset(MockRegs, 0, sizeof(MockRegs));
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MockSendByte()
+*
+* Description: Shift one byte into the modelled chain, MSB first.  What falls out of the top of one
+*              chip's shift register (DOUT) goes into the next chip.
+* Arguments  : data = byte sent by the driver
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MockSendByte (unsigned char data) {
+  unsigned char chip;
+  unsigned int  carry = data;
+  unsigned int  out;
+
+  for (chip = 0; chip < MockChain; chip++) {
+    out = MockShift[chip] >> 8;
+    MockShift[chip] = ((MockShift[chip] << 8) | carry) & 0xffff;
+    carry = out;
+  }
+  MockBytes++;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MockLoad()
+*
+* Description: Drive the LOAD line; every chip latches its shift register on the rising edge.
+* Arguments  : level = 0 or 1
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MockLoad (unsigned char level) {
+  unsigned char chip, reg;
+
+  if (level && !MockLoad) {
+    for (chip = 0; chip < MockChain; chip++) {
+      reg = (MockShift[chip] >> 8) & 0x0f;
+      if (reg != 0x00) {                              // register 0x00 is the no-op
+        MockRegs[chip][reg] = MockShift[chip] & 0xff;
+        MockWrites++;
+      }
+    }
+    MAX7219CaptureFrame(MockChain, MockShift, 8 * (MockBytes - MockLatchBytes),
+                        MockBytes - MockLatchBytes != 2UL * MockChain);
+    MockLatchBytes = MockBytes;
+    MockFrames++;
+  }
+  MockLoad = level;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MockSendAsync()
+*
+* Description: Start an interrupt driven frame the way the ATmega SPI transport does: LOAD high, first
+*              byte out, the rest from MAX7219MockIrq().
+* Arguments  : frame = bytes to send
+*              len = number of bytes
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MockSendAsync (const unsigned char *frame, unsigned char len) {
+  MAX7219MockLoad(1);
+  MAX7219MockSendByte(frame[0]);
+  MockAsyncNext   = frame + 1;
+  MockAsyncLeft   = len - 1;
+  MockAsyncActive = 1;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MockIrq()
+*
+* Description: Play one "transfer complete" interrupt: send the next byte, or latch the frame and let
+*              the driver start the next one.
+* Arguments  : none
+* Returns    : 1 if an interrupt was pending, 0 if the bus is idle
+*********************************************************************************************************
+*/
+unsigned char MAX7219MockIrq (void) {
+  if (!MockAsyncActive)
+    return 0;
+  if (MockAsyncLeft) {
+    MockAsyncLeft--;
+    MAX7219MockSendByte(*MockAsyncNext++);
+    return 1;
+  }
+  MockAsyncActive = 0;
+  MAX7219MockLoad(0);
+  MAX7219MockLoad(1);
+  MAX7219AsyncFrameDone();
+  return 1;
+}
+
+
+unsigned long MAX7219MockBytes (void) {
+  return MockBytes;
+}
+
+
+unsigned long MAX7219MockFrames (void) {
+  return MockFrames;
+}
+
+
+unsigned long MAX7219MockWrites (void) {
+  return MockWrites;
+}
+
+
+unsigned char MAX7219MockRegister (unsigned char chip, unsigned char reg_number) {
+  return (chip < MOCK_CHIPS) ? MockRegs[chip][reg_number & 0x0f] : 0;
+}
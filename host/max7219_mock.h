@@ -0,0 +1,42 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_MOCK.H
+* Description: Host mock transport for the MAX7219 drivers (MAX7219_TRANSPORT_MOCK).
+*
+*  Build either port on Linux with the mock transport, e.g.
+*
+*    gcc -Ihost -I. -DMAX7219_TRANSPORT=MAX7219_TRANSPORT_MOCK \
+*        max7219.c max7219_chain.c max7219_shadow.c max7219_font.c max7219_text.c \
+*        max7219_matrix.c max7219_scroll.c max7219_queue.c max7219_buffer.c max7219_sched.c \
+*        max7219_fade.c max7219_ambient.c max7219_anim.c max7219_stats.c host/host_io.c \
+*        host/max7219_sim.c host/max7219_mock.c host/max7219_capture.c app.c
+*
+*  (use max7219_32.c for the AVR32 port; without MAX7219_TRANSPORT_MOCK the same files drive the
+*  bit-banged pins into MAX7219_SIM.C instead).  The mock shifts the bytes through a model of a
+*  chain of up to 16 chips, latches on the LOAD rising edge and counts what went over the bus.
+*
+*  MAX7219FlushAsync() is supported too: MAX7219MockSendAsync() stands in for the transfer, and each
+*  call to MAX7219MockIrq() plays one "transfer complete" interrupt, as SPI_STC_vect would on an
+*  ATmega.  Call it from the test loop between units of application work.
+*********************************************************************************************************
+*/
+
+#ifndef _MAX7219_MOCK_H
+#define _MAX7219_MOCK_H
+
+/*
+*********************************************************************************************************
+* Public Function Prototypes
+*********************************************************************************************************
+*/
+void MAX7219MockReset (unsigned char chips);
+void MAX7219MockSendByte (unsigned char data);
+void MAX7219MockLoad (unsigned char level);
+void MAX7219MockSendAsync (const unsigned char *frame, unsigned char len);
+unsigned char MAX7219MockIrq (void);
+
+unsigned long MAX7219MockBytes (void);
+unsigned long MAX7219MockFrames (void);
+unsigned long MAX7219MockWrites (void);
+unsigned char MAX7219MockRegister (unsigned char chip, unsigned char reg_number);
+#endif // _MAX7219_MOCK_H
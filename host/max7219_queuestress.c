@@ -0,0 +1,231 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_QUEUESTRESS.C
+* Description: Thread stress test of the command rings of MAX7219_QUEUE.C (host build).
+*
+*  STRESS_MULTI threads post on the multi-producer ring with MAX7219QueuePutMulti() and one thread
+*  on the single producer ring with MAX7219QueuePut(), all at once, while one drain thread calls
+*  MAX7219QueueDrain() and sends the updates over the simulated bus.  Each producer owns one chip and
+*  posts every (register, value) pair of its digit registers once, in order.  The updates are counted
+*  as the drain takes them, before the shadow registers can merge them, so the test sees every
+*  update arrive exactly once, in the order it was posted.  In the end each chip must hold the last
+*  values posted and the simulator must not have seen a torn frame.  The exit status is 1 on any
+*  failure.
+*
+*    gcc -std=gnu99 -pthread -Ihost -I. -DMAX7219_CHAIN_MAX=4 -o max7219_queuestress max7219.c \
+*        max7219_chain.c max7219_shadow.c max7219_font.c max7219_text.c max7219_matrix.c \
+*        max7219_scroll.c max7219_buffer.c max7219_sched.c max7219_fade.c max7219_ambient.c \
+*        max7219_anim.c max7219_stats.c host/host_io.c host/max7219_sim.c host/max7219_mock.c \
+*        host/max7219_capture.c host/max7219_queuestress.c
+*
+*  The test includes max7219_queue.c itself, to count what the drain hands to the shadow registers,
+*  so that file is not on the command line.  -DMAX7219_QUEUE_SIZE=n checks other ring sizes.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include "max7219.h"
+#include "max7219_sim.h"
+
+static void StressArrive (unsigned char chip, unsigned char reg_number, unsigned char data);
+
+#define MAX7219SetRegisterChip  StressArrive          // the drain's updates go through the counter
+#include "max7219_queue.c"
+#undef MAX7219SetRegisterChip
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define STRESS_MULTI      3                           // threads on the multi-producer ring
+#define STRESS_UPDATES    (8 * 256)                   // updates per producer: digits 1-8, values 0-255
+#define STRESS_PASSES     20
+
+#if MAX7219_CHAIN_MAX < STRESS_MULTI + 1
+#error "build with -DMAX7219_CHAIN_MAX=4 or more: every producer needs its own chip"
+#endif
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static unsigned int  StressNext[STRESS_MULTI + 1];    // update each chip should receive next
+static volatile unsigned long StressErrors;           // updates lost, repeated or out of order
+static unsigned long StressDrains;                    // MAX7219QueueDrain() calls that found work
+static unsigned int  StressLargest;                   // most updates taken by one drain
+static volatile int  StressRunning;                   // producers still posting
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void *StressProduce (void *arg);
+static void *StressDrain (void *arg);
+static int StressPass (unsigned int pass);
+
+
+// ....................................... Test Main ...................................................
+
+/*
+*********************************************************************************************************
+* main()
+*********************************************************************************************************
+*/
+int main (void) {
+  unsigned int pass;
+  int failed = 0;
+
+  MAX7219SimReset(MAX7219_CHAIN_MAX);
+  MAX7219Init();
+  for (pass = 0; pass < STRESS_PASSES && !failed; pass++)
+    failed = StressPass(pass);
+
+  printf("%u passes, %d producers, %u updates each, ring size %d: %lu drains, up to %u updates each\n",
+         pass, STRESS_MULTI + 1, STRESS_UPDATES, MAX7219_QUEUE_SIZE, StressDrains, StressLargest);
+  printf("%s\n", failed ? "FAIL" : "ok");
+  return failed;
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* StressPass()
+*
+* Description: Run every producer and the drain once, then check the counts and the chips.
+*********************************************************************************************************
+*/
+static int StressPass (unsigned int pass) {
+  pthread_t producer[STRESS_MULTI + 1], drain;
+  unsigned char chip, reg;
+  int failed = 0;
+
+  for (chip = 0; chip <= STRESS_MULTI; chip++)
+    StressNext[chip] = 0;
+  StressRunning = STRESS_MULTI + 1;
+  pthread_create(&drain, NULL, StressDrain, NULL);
+  for (chip = 0; chip <= STRESS_MULTI; chip++)        // the last chip's producer uses the single ring
+    pthread_create(&producer[chip], NULL, StressProduce, (void *)(long)chip);
+  for (chip = 0; chip <= STRESS_MULTI; chip++)
+    pthread_join(producer[chip], NULL);
+  pthread_join(drain, NULL);
+
+  for (chip = 0; chip <= STRESS_MULTI; chip++) {
+    if (StressNext[chip] != STRESS_UPDATES) {
+      printf("FAIL: pass %u: chip %u received %u of %u updates\n", pass, chip, StressNext[chip],
+             STRESS_UPDATES);
+      failed = 1;
+    }
+    for (reg = REG_DIGIT0; reg < REG_DIGIT0 + 8; reg++)
+      if (MAX7219SimRegister(chip, reg) != 0xff) {
+        printf("FAIL: pass %u: chip %u register 0x%02x is %02x, not the last value posted\n", pass, chip,
+               reg, MAX7219SimRegister(chip, reg));
+        failed = 1;
+      }
+  }
+  if (StressErrors) {
+    printf("FAIL: pass %u: %lu updates lost, repeated or out of order\n", pass, StressErrors);
+    failed = 1;
+  }
+  if (MAX7219SimBadFrames()) {
+    printf("FAIL: pass %u: %lu frames were not 16 bits per chip\n", pass, MAX7219SimBadFrames());
+    failed = 1;
+  }
+  return failed;
+}
+
+
+/*
+*********************************************************************************************************
+* StressProduce()
+*
+* Description: Producer thread: post every value of every digit of its chip, retrying while the ring
+*              is full.  Chip STRESS_MULTI posts on the single producer ring, the others on the
+*              multi-producer ring.
+*********************************************************************************************************
+*/
+static void *StressProduce (void *arg) {
+  unsigned char chip = (unsigned char)(long)arg;
+  unsigned int update, random = 2463534242U + chip;
+
+  for (update = 0; update < STRESS_UPDATES && !StressErrors; update++) {
+    unsigned char reg = REG_DIGIT0 + update / 256, data = (unsigned char)update;
+    while (!(chip == STRESS_MULTI ? MAX7219QueuePut(chip, reg, data) :
+                                    MAX7219QueuePutMulti(chip, reg, data)) && !StressErrors)
+      sched_yield();
+    random ^= random << 13;                           // xorshift: give up the CPU at random points,
+    random ^= random >> 17;                           // so the drain also finds part-filled rings
+    random ^= random << 5;                            // when the threads share one core
+    if ((random & 7) == 0)
+      sched_yield();
+  }
+  __atomic_sub_fetch(&StressRunning, 1, __ATOMIC_SEQ_CST);
+  return NULL;
+}
+
+
+/*
+*********************************************************************************************************
+* StressDrain()
+*
+* Description: Drain thread: the only one that uses the driver.  Drains until every producer has
+*              finished and the rings are empty.  On the first bad update the producers and the drain
+*              give up, so a broken ring fails the test instead of hanging it.
+*********************************************************************************************************
+*/
+static void *StressDrain (void *arg) {
+  unsigned int count;
+  int running;
+
+  (void)arg;
+  do {
+    running = __atomic_load_n(&StressRunning, __ATOMIC_SEQ_CST);
+    count = MAX7219QueueDrain();
+    if (count) {
+      StressDrains++;
+      if (count > StressLargest)
+        StressLargest = count;
+    } else
+      sched_yield();
+  } while ((running || count) && !StressErrors);
+  return NULL;
+}
+
+
+/*
+*********************************************************************************************************
+* StressArrive()
+*
+* Description: Stands in for MAX7219SetRegisterChip() in the drain: check that the update is the one
+*              its producer posted next, then pass it on.
+*********************************************************************************************************
+*/
+static void StressArrive (unsigned char chip, unsigned char reg_number, unsigned char data) {
+  if (chip > STRESS_MULTI ||
+      (unsigned int)(reg_number - REG_DIGIT0) * 256 + data != StressNext[chip]) {
+    StressErrors++;
+    return;
+  }
+  StressNext[chip]++;
+  MAX7219SetRegisterChip(chip, reg_number, data);
+}
@@ -0,0 +1,313 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_REPLAY.C
+* Description: Replay and comparison of bus traces written by MAX7219_CAPTURE.C (host tool).
+*
+*  Replays a trace against a model of the chain and reports what the bus carried: LOAD frames,
+*  register writes, redundant writes (a register written with the value it already held), bits, bus
+*  utilisation (bits against the time the trace covers) and the registers of every chip at the end.
+*
+*    gcc -o max7219_replay host/max7219_replay.c
+*    max7219_replay [-v] trace                      report one trace
+*    max7219_replay [-t percent] base trace         compare a trace against a base line
+*
+*  -v also prints every frame with its time, the words it carried and digits 1-8 of chip 0 after it.
+*  With two traces the report gives both and the change; the exit status is 1 if the second trace
+*  needs more than percent (default 0) more frames or bits than the first, or leaves the chips in a
+*  different state, so a CI job can fail on a regression.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "max7219_capture.h"
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define REPLAY_CHIPS      256                         // chain length fits the header's byte
+#define REPLAY_REGS       16
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+struct replay {
+  const char *name;                                   // file name
+  unsigned int chips;                                 // chain length from the header
+  unsigned int lines;                                 // DATA lines the chain is split into
+  unsigned long bus_hz;                               // bus clock of the time stamps
+  unsigned long long time;                            // bus clock periods up to the last frame
+  unsigned long frames;                               // LOAD frames
+  unsigned long bad;                                  // frames that were not 16 bits per chip
+  unsigned long writes;                               // words other than no-ops
+  unsigned long redundant;                            // writes of the value the register held
+  unsigned long reg_writes[REPLAY_REGS];              // writes per register
+  unsigned long reg_redundant[REPLAY_REGS];           // redundant writes per register
+  unsigned char regs[REPLAY_CHIPS][REPLAY_REGS];      // register contents
+  unsigned char known[REPLAY_CHIPS][REPLAY_REGS];     // register written at least once
+};
+
+static struct replay ReplayA, ReplayB;
+
+static const char *ReplayRegName[REPLAY_REGS] = {
+  "noop", "digit1", "digit2", "digit3", "digit4", "digit5", "digit6", "digit7", "digit8",
+  "decode", "intensity", "scan", "shutdown", "0x0d", "0x0e", "test"
+};
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static int  ReplayLoad (struct replay *r, const char *name, int verbose);
+static void ReplayReport (const struct replay *r);
+static int  ReplayCompare (const struct replay *a, const struct replay *b, double percent);
+static unsigned long long ReplayBits (const struct replay *r);
+static double ReplayUtil (const struct replay *r);
+
+
+/*
+*********************************************************************************************************
+* main()
+*********************************************************************************************************
+*/
+int main (int argc, char **argv) {
+  const char *files[2];
+  double percent = 0.0;
+  int verbose = 0, count = 0, opt;
+
+  for (opt = 1; opt < argc; opt++) {
+    if (strcmp(argv[opt], "-v") == 0)
+      verbose = 1;
+    else if (strcmp(argv[opt], "-t") == 0 && opt + 1 < argc)
+      percent = strtod(argv[++opt], NULL);
+    else if (argv[opt][0] != '-' && count < 2)
+      files[count++] = argv[opt];
+    else
+      break;
+  }
+  if (opt < argc || count < 1) {
+    fprintf(stderr, "usage: %s [-v] trace\n       %s [-t percent] base trace\n", argv[0], argv[0]);
+    return 2;
+  }
+
+  if (!ReplayLoad(&ReplayA, files[0], verbose && count == 1))
+    return 2;
+  if (count == 1) {
+    ReplayReport(&ReplayA);
+    return 0;
+  }
+  if (!ReplayLoad(&ReplayB, files[1], 0))
+    return 2;
+  return ReplayCompare(&ReplayA, &ReplayB, percent);
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* ReplayLoad()
+*
+* Description: Read a trace and replay it into r.  Returns 1 on success; reports errors on stderr.
+*********************************************************************************************************
+*/
+static int ReplayLoad (struct replay *r, const char *name, int verbose) {
+  unsigned char header[CAPTURE_HEADER], word[3];
+  unsigned long long delta;
+  unsigned int shift, i, count, digit;
+  FILE *in;
+  int c;
+
+  memset(r, 0, sizeof(*r));
+  r->name = name;
+  if ((in = fopen(name, "rb")) == NULL) {
+    perror(name);
+    return 0;
+  }
+  if (fread(header, 1, sizeof(header), in) != sizeof(header) ||
+      memcmp(header, CAPTURE_MAGIC, 4) != 0 || header[4] != CAPTURE_VERSION) {
+    fprintf(stderr, "%s: not a version %d MAX7219 trace\n", name, CAPTURE_VERSION);
+    fclose(in);
+    return 0;
+  }
+  r->chips  = header[5] ? header[5] : 1;
+  r->lines  = header[6] ? header[6] : 1;
+  r->bus_hz = header[8] | (header[9] << 8) | ((unsigned long)header[10] << 16) |
+              ((unsigned long)header[11] << 24);
+
+  while ((c = fgetc(in)) != EOF) {
+    for (delta = 0, shift = 0; c & 0x80; shift += 7) {  // varint time since the previous frame
+      delta |= (unsigned long long)(c & 0x7f) << shift;
+      if ((c = fgetc(in)) == EOF)
+        break;
+    }
+    delta |= (unsigned long long)(c & 0x7f) << shift;
+    if (c == EOF || (c = fgetc(in)) == EOF) {
+      fprintf(stderr, "%s: truncated frame %lu\n", name, r->frames + 1);
+      fclose(in);
+      return 0;
+    }
+    r->time += delta;
+    r->frames++;
+    if (c & CAPTURE_BAD)
+      r->bad++;
+    count = c & ~CAPTURE_BAD;
+
+    if (verbose)
+      printf("%12.1f us  frame %-6lu", r->time * 1e6 / r->bus_hz, r->frames);
+    for (i = 0; i < count; i++) {
+      if (fread(word, 1, 3, in) != 3) {
+        fprintf(stderr, "%s: truncated frame %lu\n", name, r->frames);
+        fclose(in);
+        return 0;
+      }
+      word[1] &= 0x0f;
+      r->writes++;
+      r->reg_writes[word[1]]++;
+      if (r->known[word[0]][word[1]] && r->regs[word[0]][word[1]] == word[2]) {
+        r->redundant++;
+        r->reg_redundant[word[1]]++;
+      }
+      r->regs[word[0]][word[1]]  = word[2];
+      r->known[word[0]][word[1]] = 1;
+      if (verbose)
+        printf(" %u:%s=%02x", word[0], ReplayRegName[word[1]], word[2]);
+    }
+    if (verbose) {
+      printf("%s  |", (c & CAPTURE_BAD) ? " BAD" : "");
+      for (digit = 1; digit <= 8; digit++)
+        printf(" %02x", r->regs[0][digit]);
+      printf("\n");
+    }
+  }
+  fclose(in);
+  return 1;
+}
+
+
+/*
+*********************************************************************************************************
+* ReplayReport()
+*
+* Description: Print the figures of one trace and the final state of every chip.
+*********************************************************************************************************
+*/
+static void ReplayReport (const struct replay *r) {
+  unsigned int chip, reg;
+
+  printf("trace        %s\n", r->name);
+  printf("chain        %u\n", r->chips);
+  printf("data_lines   %u\n", r->lines);
+  printf("bus_hz       %lu\n", r->bus_hz);
+  printf("time_us      %.1f\n", r->time * 1e6 / r->bus_hz);
+  printf("frames       %lu\n", r->frames);
+  printf("bad_frames   %lu\n", r->bad);
+  printf("writes       %lu\n", r->writes);
+  printf("redundant    %lu\n", r->redundant);
+  printf("bits         %llu\n", ReplayBits(r));
+  printf("utilisation  %.3f%%\n", ReplayUtil(r));
+
+  printf("\nregister     writes  redundant\n");
+  for (reg = 1; reg < REPLAY_REGS; reg++)
+    if (r->reg_writes[reg])
+      printf("%-10s %8lu %10lu\n", ReplayRegName[reg], r->reg_writes[reg], r->reg_redundant[reg]);
+
+  printf("\nchip  digit1-8                 decode intensity scan shutdown test\n");
+  for (chip = 0; chip < r->chips; chip++) {
+    printf("%4u ", chip);
+    for (reg = 1; reg <= 8; reg++)
+      printf(" %02x", r->regs[chip][reg]);
+    printf("  %02x     %02x        %02x   %02x       %02x\n", r->regs[chip][9], r->regs[chip][10],
+           r->regs[chip][11], r->regs[chip][12], r->regs[chip][15]);
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* ReplayCompare()
+*
+* Description: Print the figures of two traces side by side.  Returns 1 if the second is worse by
+*              more than percent or ends in a different state, 0 otherwise.
+*********************************************************************************************************
+*/
+static int ReplayCompare (const struct replay *a, const struct replay *b, double percent) {
+  unsigned int chip, reg, differ = 0;
+  double limit = 1.0 + percent / 100.0;
+  int worse = 0;
+
+  printf("%-12s %14s %14s %10s\n", "", "base", "trace", "change");
+#define REPLAY_ROW(label, x, y) \
+  printf("%-12s %14.0f %14.0f %9.1f%%\n", label, (double)(x), (double)(y), \
+         (x) ? 100.0 * ((double)(y) - (double)(x)) / (double)(x) : 0.0)
+  REPLAY_ROW("frames",    a->frames,    b->frames);
+  REPLAY_ROW("writes",    a->writes,    b->writes);
+  REPLAY_ROW("redundant", a->redundant, b->redundant);
+  REPLAY_ROW("bits",      ReplayBits(a), ReplayBits(b));
+  REPLAY_ROW("bad_frames", a->bad,      b->bad);
+#undef REPLAY_ROW
+  printf("%-12s %13.3f%% %13.3f%%\n", "utilisation", ReplayUtil(a), ReplayUtil(b));
+
+  for (chip = 0; chip < REPLAY_CHIPS; chip++)
+    for (reg = 1; reg < REPLAY_REGS; reg++)
+      if (a->regs[chip][reg] != b->regs[chip][reg]) {
+        if (differ++ < 8)
+          printf("state differs: chip %u %s %02x -> %02x\n", chip, ReplayRegName[reg],
+                 a->regs[chip][reg], b->regs[chip][reg]);
+      }
+
+  if (b->frames > a->frames * limit || ReplayBits(b) > ReplayBits(a) * limit) {
+    printf("REGRESSION: more than %.1f%% more bus traffic\n", percent);
+    worse = 1;
+  }
+  if (differ) {
+    printf("REGRESSION: %u registers end in a different state\n", differ);
+    worse = 1;
+  }
+  return worse;
+}
+
+
+/*
+*********************************************************************************************************
+* ReplayBits()
+*
+* Description: Bits clocked: 16 per chip per frame.
+*********************************************************************************************************
+*/
+static unsigned long long ReplayBits (const struct replay *r) {
+  return 16ULL * r->chips * r->frames;
+}
+
+
+/*
+*********************************************************************************************************
+* ReplayUtil()
+*
+* Description: Bus utilisation in percent: clock periods spent shifting frames against the periods
+*              the trace covers.  With several DATA lines each clock carries a bit for every line.
+*********************************************************************************************************
+*/
+static double ReplayUtil (const struct replay *r) {
+  return r->time ? 100.0 * ReplayBits(r) / r->lines / r->time : 0.0;
+}
@@ -0,0 +1,180 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_SIM.C
+* Description: Pin-level MAX7219 simulator (see MAX7219_SIM.H).
+*
+*  Datasheet behaviour modelled: DIN is sampled on the rising edge of CLK into a 16-bit shift
+*  register; the bit shifted out of D15 appears on DOUT and feeds the next chip's DIN; the rising edge
+*  of LOAD latches D11-D8 (address) and D7-D0 (data).  Address 0x00 is the no-op register.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include <string.h>
+#include "max7219_sim.h"
+#include "max7219_capture.h"
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define SIM_CHIPS         16                          // longest chain the simulator can model
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static unsigned char SimChain = 1;                    // chips in the modelled chain
+static unsigned char SimLines = 1;                    // separate chains it is split into
+static unsigned int  SimShift[SIM_CHIPS];             // each chip's 16-bit shift register
+static unsigned char SimRegs[SIM_CHIPS][16];          // latched register contents
+static unsigned char SimClk;                          // CLK level seen last
+static unsigned char SimLoad;                         // LOAD level seen last
+static unsigned long SimBits;                         // bits clocked since the last latch
+static unsigned long SimPinWrites;
+static unsigned long SimClocks;
+static unsigned long SimFrames;
+static unsigned long SimWrites;
+static unsigned long SimBadFrames;
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219SimReset()
+*
+* Description: Clear the modelled chips and the counters.
+* Arguments  : chips = number of chips in the modelled chain (1-16)
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SimReset (unsigned char chips) {
+  HostIoSync();                                       // don't let an old write leak into the new run
+  SimChain = (chips < 1) ? 1 : (chips > SIM_CHIPS) ? SIM_CHIPS : chips;
+  SimLines = 1;
+  memset(SimShift, 0, sizeof(SimShift));
+  memset(SimRegs, 0, sizeof(SimRegs));
+  SimBits      = 0;
+  SimPinWrites = 0;
+  SimClocks    = 0;
+  SimFrames    = 0;
+  SimWrites    = 0;
+  SimBadFrames = 0;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SimSetLines()
+*
+* Description: Split the modelled chain into separate chains that share CLK and LOAD, each with its
+*              own DATA line (MAX7219_TRANSPORT_PARALLEL).  Chain n is chips n * P to n * P + P - 1.
+*              MAX7219SimReset() goes back to one chain.
+* Arguments  : lines = number of chains (1-8), dividing the chip count
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SimSetLines (unsigned char lines) {
+  if (lines >= 1 && lines <= 8 && SimChain % lines == 0)
+    SimLines = lines;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SimPins()
+*
+* Description: Present new pin levels to the model.  Called once for every pin write.
+* Arguments  : data = DATA level (0 or 1); with several chains, bit n is the DATA line of chain n
+*              clk, load = pin levels (0 or 1) after the write
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SimPins (unsigned char data, unsigned char clk, unsigned char load) {
+  unsigned char chip, reg, per_line = SimChain / SimLines;
+  unsigned int  carry = 0, out;
+
+  SimPinWrites++;
+
+  if (clk && !SimClk) {                               // CLK rising edge: shift DIN in
+    for (chip = 0; chip < SimChain; chip++) {
+      if (chip % per_line == 0)                       // first chip of a chain: its DATA line
+        carry = (data >> (chip / per_line)) & 1;
+      out = (SimShift[chip] >> 15) & 1;               // DOUT of this chip is DIN of the next
+      SimShift[chip] = ((SimShift[chip] << 1) | carry) & 0xffff;
+      carry = out;
+    }
+    SimBits++;
+    SimClocks++;
+  }
+  SimClk = clk;
+
+  if (load && !SimLoad && SimBits) {                  // LOAD rising edge: latch every chip
+    for (chip = 0; chip < SimChain; chip++) {
+      reg = (SimShift[chip] >> 8) & 0x0f;
+      if (reg != 0x00) {
+        SimRegs[chip][reg] = SimShift[chip] & 0xff;
+        SimWrites++;
+      }
+    }
+    MAX7219CaptureFrame(SimChain, SimShift, SimBits, SimBits != 16UL * per_line);
+    if (SimBits != 16UL * per_line)
+      SimBadFrames++;
+    SimBits = 0;
+    SimFrames++;
+  }
+  SimLoad = load;
+}
+
+
+unsigned long MAX7219SimPinWrites (void) {
+  HostIoSync();
+  return SimPinWrites;
+}
+
+
+unsigned long MAX7219SimClocks (void) {
+  HostIoSync();
+  return SimClocks;
+}
+
+
+unsigned long MAX7219SimFrames (void) {
+  HostIoSync();
+  return SimFrames;
+}
+
+
+unsigned long MAX7219SimWrites (void) {
+  HostIoSync();
+  return SimWrites;
+}
+
+
+unsigned long MAX7219SimBadFrames (void) {
+  HostIoSync();
+  return SimBadFrames;
+}
+
+
+unsigned char MAX7219SimRegister (unsigned char chip, unsigned char reg_number) {
+  HostIoSync();
+  return (chip < SIM_CHIPS) ? SimRegs[chip][reg_number & 0x0f] : 0;
+}
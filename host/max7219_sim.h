@@ -0,0 +1,47 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_SIM.H
+* Description: Pin-level MAX7219 simulator for host builds of the bit-banged drivers.
+*
+*  Build either port unmodified on Linux, e.g.
+*
+*    gcc -Ihost -I. max7219.c max7219_chain.c max7219_shadow.c max7219_font.c max7219_text.c \
+*        max7219_matrix.c max7219_scroll.c max7219_queue.c max7219_buffer.c max7219_sched.c \
+*        max7219_fade.c max7219_ambient.c max7219_anim.c max7219_stats.c host/host_io.c \
+*        host/max7219_sim.c host/max7219_mock.c host/max7219_capture.c app.c
+*
+*  (use max7219_32.c for the AVR32 port).  HOST_IO.C passes every write to the DATA/CLK/LOAD pins
+*  to MAX7219SimPins().  The model shifts DATA in on each CLK rising edge through a chain of up to 16
+*  chips, latches on the LOAD rising edge and counts pin writes, clock edges and frames, so the cost
+*  of any driver call can be read as the difference of the counters before and after it.
+*********************************************************************************************************
+*/
+
+#ifndef _MAX7219_SIM_H
+#define _MAX7219_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+*********************************************************************************************************
+* Public Function Prototypes
+*********************************************************************************************************
+*/
+void MAX7219SimReset (unsigned char chips);
+void MAX7219SimSetLines (unsigned char lines);
+void MAX7219SimPins (unsigned char data, unsigned char clk, unsigned char load);
+
+unsigned long MAX7219SimPinWrites (void);             // writes to any of the three pins
+unsigned long MAX7219SimClocks (void);                // CLK rising edges
+unsigned long MAX7219SimFrames (void);                // LOAD rising edges with data clocked in
+unsigned long MAX7219SimWrites (void);                // words latched into a register other than no-op
+unsigned long MAX7219SimBadFrames (void);             // frames that were not 16 bits per chip
+unsigned char MAX7219SimRegister (unsigned char chip, unsigned char reg_number);
+
+void HostIoSync (void);                               // HOST_IO.C
+#ifdef __cplusplus
+}
+#endif
+#endif // _MAX7219_SIM_H
@@ -0,0 +1,324 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_TPLCHECK.CPP
+* Description: Checks the C++ template driver (MAX7219.HPP) against MAX7219.C on the host simulator.
+*
+*  Runs the same calls through MAX7219.C and through a Max7219<> bound to the same pins (DATA PC0,
+*  CLK PC2, LOAD PC1) and prints, per case and driver, the pin writes, CLK edges, LOAD frames and
+*  register writes it cost, and the host time per call.  The exit status is 1 if the template sends
+*  more than the C driver, leaves the chips in a different state, or takes more than
+*  CHECK_SLOWER_PCT percent longer.
+*
+*  The time is the best of CHECK_ROUNDS runs of the case body, measured with clock_gettime(); the
+*  setup is not timed, and the two drivers take turns, so a busy host slows both alike.  The time
+*  includes the simulator, which every PORTC write calls.  Both drivers make the same pin writes, so
+*  that part is the same for both and the difference is the drivers' own code.  This is the host
+*  CPU, not the ATmega or the UC3L, and the UC3L pins (Max7219LocalPin) are not built here.  Code
+*  size is compared by host/max7219_tplsize.cpp.
+*
+*    gcc -std=gnu99 -Os -Ihost -I. -c max7219.c max7219_chain.c max7219_shadow.c max7219_font.c \
+*        max7219_text.c max7219_matrix.c max7219_scroll.c max7219_queue.c max7219_buffer.c \
+*        max7219_sched.c max7219_fade.c max7219_ambient.c max7219_anim.c max7219_stats.c \
+*        host/host_io.c host/max7219_sim.c host/max7219_mock.c host/max7219_capture.c
+*    g++ -std=gnu++11 -Os -Ihost -I. -o max7219_tplcheck *.o host/max7219_tplcheck.cpp
+*
+*  MAX7219.C runs with MAX7219SetAutoPower(0), since the template has no automatic power modes.
+*  -DMAX7219_CHAIN_MAX=n (on both lines) checks a chain of n chips.  A second display on PORTD, which
+*  the simulator does not watch, runs alongside to show that instances do not disturb each other.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include <stdio.h>
+#include <time.h>
+#include "max7219.hpp"
+#include "max7219_sim.h"
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define CHECK_ROUNDS      15                          // timed runs per case and driver, best one counts
+#define CHECK_REPEAT      50                          // calls per timed run, in units of the case's calls
+#define CHECK_SLOWER_PCT  10                          // allowance for timer noise
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+typedef Max7219Pins<Max7219AvrPin<Max7219PortC, 0>,   // the pins of MAX7219.C
+                    Max7219AvrPin<Max7219PortC, 2>,
+                    Max7219AvrPin<Max7219PortC, 1> > CheckPins;
+typedef Max7219Pins<Max7219AvrPin<Max7219PortD, 0>,
+                    Max7219AvrPin<Max7219PortD, 2>,
+                    Max7219AvrPin<Max7219PortD, 1> > PanelPins;
+typedef Max7219<CheckPins, MAX7219_CHAIN_MAX> CheckDisplay;
+
+static_assert(sizeof(CheckDisplay) == 18 * MAX7219_CHAIN_MAX, "a display is its shadow registers only");
+static_assert(Max7219Glyph('8') == (SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G),
+              "the font is usable at compile time");
+
+struct check_count {
+  unsigned long pins;                                 // DATA/CLK/LOAD writes
+  unsigned long clocks;                               // CLK rising edges
+  unsigned long frames;                               // LOAD frames
+  unsigned long writes;                               // registers latched
+};
+
+static CheckDisplay Display;                          // the display under test
+static Max7219<PanelPins, 4> Panel;                   // a second display, on PORTD
+static unsigned char CheckDigit;                      // rolling content for the refresh case
+static int CheckFailed;
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void CheckRun (const char *name, void (*setup)(int, unsigned long),
+                      void (*body)(int, unsigned long), unsigned long calls);
+static void CheckRead (struct check_count *count);
+static void CheckTime (void (*setup)(int, unsigned long), void (*body)(int, unsigned long),
+                       unsigned long calls, double *ns);
+
+
+// ....................................... Check Cases .................................................
+// tpl = 1 runs the template, 0 MAX7219.C; both act on chip 0.
+
+static void SetupNone (int tpl, unsigned long i) { (void)tpl; (void)i; }
+
+static void SetupEights (int tpl, unsigned long i) {
+  char d;
+  (void)i;
+  for (d = 1; d <= 8; d++)
+    tpl ? Display.DisplayChar(0, d, '8', SEG_DP) : MAX7219DisplayChar(d, '8', SEG_DP);
+  tpl ? Display.Flush() : MAX7219Flush();
+}
+
+static void SetupBlankDigit (int tpl, unsigned long i) {
+  (void)i;
+  tpl ? Display.DisplayChar(0, 1, ' ', 0) : MAX7219DisplayChar(1, ' ', 0);
+  tpl ? Display.Flush() : MAX7219Flush();
+}
+
+static void SetupDim (int tpl, unsigned long i) {
+  (void)i;
+  tpl ? Display.SetBrightness(0, 3) : MAX7219SetBrightness(3);
+  tpl ? Display.Flush() : MAX7219Flush();
+}
+
+static void BodyInit (int tpl, unsigned long i) { (void)i; tpl ? Display.Init() : MAX7219Init(); }
+
+static void BodyWrite (int tpl, unsigned long i) {
+  uint8_t reg = REG_DIGIT0 + (i & 7);
+  tpl ? Display.Write(0, reg, (uint8_t)i) : MAX7219Write(reg, (uint8_t)i);
+}
+
+static void BodyWriteAll (int tpl, unsigned long i) {
+  uint8_t reg = REG_DIGIT0 + (i & 7);
+  tpl ? Display.WriteAll(reg, (uint8_t)i) : MAX7219WriteAll(reg, (uint8_t)i);
+}
+
+static void BodyClear (int tpl, unsigned long i) {
+  (void)i;
+  tpl ? Display.Clear(0) : MAX7219Clear();
+  tpl ? Display.Flush() : MAX7219Flush();
+}
+
+static void BodyChar (int tpl, unsigned long i) {
+  (void)i;
+  tpl ? Display.DisplayChar(0, 1, 'A', SEG_DP) : MAX7219DisplayChar(1, 'A', SEG_DP);
+  tpl ? Display.Flush() : MAX7219Flush();
+}
+
+static void BodyBright (int tpl, unsigned long i) {
+  (void)i;
+  tpl ? Display.SetBrightness(0, 15) : MAX7219SetBrightness(15);
+  tpl ? Display.Flush() : MAX7219Flush();
+}
+
+static void BodyString (int tpl, unsigned long i) {
+  (void)i;
+  tpl ? Display.DisplayString(0, 1, "12.34 Ab") : MAX7219DisplayString(1, "12.34 Ab");
+  tpl ? Display.Flush() : MAX7219Flush();
+}
+
+static void BodyRefresh (int tpl, unsigned long i) {
+  char d;
+  (void)i;
+  CheckDigit = (CheckDigit == '9') ? '0' : CheckDigit + 1;  // every digit changes every pass
+  for (d = 1; d <= 8; d++)
+    tpl ? Display.DisplayChar(0, d, CheckDigit, 0) : MAX7219DisplayChar(d, CheckDigit, 0);
+  tpl ? Display.Flush() : MAX7219Flush();
+}
+
+
+/*
+*********************************************************************************************************
+* main()
+*********************************************************************************************************
+*/
+int main (void) {
+  MAX7219SetAutoPower(0);                             // the template sends registers as set
+  Panel.Init();                                       // runs beside the display under test
+  Panel.DisplayString(3, 1, "PANEL");
+  Panel.Flush();
+
+  printf("driver,chain,case,calls,pin_writes,clock_edges,load_frames,reg_writes,host_ns\n");
+
+  CheckRun("Init",                 SetupNone,       BodyInit,     1);
+  CheckRun("Write",                SetupNone,       BodyWrite,    64);
+  CheckRun("WriteAll",             SetupNone,       BodyWriteAll, 64);
+  CheckRun("Clear",                SetupEights,     BodyClear,    16);
+  CheckRun("Clear/unchanged",      SetupNone,       BodyClear,    16);
+  CheckRun("DisplayChar",          SetupBlankDigit, BodyChar,     16);
+  CheckRun("SetBrightness",        SetupDim,        BodyBright,   16);
+  CheckRun("DisplayString",        SetupNone,       BodyString,   16);
+  CheckRun("refresh/8-digits",     SetupNone,       BodyRefresh,  100);
+
+  if (Panel.GetRegister(3, REG_DIGIT0) != Max7219Glyph('P')) {
+    printf("FAIL: the second display lost its contents\n");
+    CheckFailed = 1;
+  }
+  return CheckFailed;
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* CheckRun()
+*
+* Description: Run one case through both drivers from initialised chips, print both rows and compare
+*              the traffic, the final chip registers and the time per call.
+*********************************************************************************************************
+*/
+static void CheckRun (const char *name, void (*setup)(int, unsigned long),
+                      void (*body)(int, unsigned long), unsigned long calls) {
+  static const char *driver[2] = {"c", "template"};
+  struct check_count before, after, total[2];
+  unsigned char regs[MAX7219_CHAIN_MAX][16];
+  double ns[2];
+  unsigned char chip, reg;
+  unsigned long i;
+  int tpl;
+
+  for (tpl = 0; tpl < 2; tpl++) {
+    MAX7219SimReset(MAX7219_CHAIN_MAX);
+    tpl ? Display.Init() : MAX7219Init();             // every case starts from an initialised display
+    CheckDigit = '0';
+    total[tpl].pins = total[tpl].clocks = total[tpl].frames = total[tpl].writes = 0;
+
+    for (i = 0; i < calls; i++) {
+      setup(tpl, i);
+      CheckRead(&before);
+      body(tpl, i);
+      CheckRead(&after);
+      total[tpl].pins   += after.pins   - before.pins;
+      total[tpl].clocks += after.clocks - before.clocks;
+      total[tpl].frames += after.frames - before.frames;
+      total[tpl].writes += after.writes - before.writes;
+    }
+
+    for (chip = 0; chip < MAX7219_CHAIN_MAX; chip++) {
+      for (reg = 1; reg < 16; reg++) {
+        if (tpl == 0)
+          regs[chip][reg] = MAX7219SimRegister(chip, reg);
+        else if (regs[chip][reg] != MAX7219SimRegister(chip, reg)) {
+          printf("FAIL: %s: chip %u register 0x%02x is %02x, %02x with MAX7219.C\n", name, chip, reg,
+                 MAX7219SimRegister(chip, reg), regs[chip][reg]);
+          CheckFailed = 1;
+        }
+      }
+    }
+    if (MAX7219SimBadFrames()) {
+      printf("FAIL: %s: %lu frames were not 16 bits per chip\n", name, MAX7219SimBadFrames());
+      CheckFailed = 1;
+    }
+  }
+
+  CheckTime(setup, body, calls, ns);
+  for (tpl = 0; tpl < 2; tpl++)
+    printf("%s,%d,%s,%lu,%.2f,%.2f,%.3f,%.3f,%.0f\n",
+           driver[tpl], MAX7219_CHAIN_MAX, name, calls,
+           (double)total[tpl].pins / calls, (double)total[tpl].clocks / calls,
+           (double)total[tpl].frames / calls, (double)total[tpl].writes / calls, ns[tpl]);
+
+  if (total[1].clocks > total[0].clocks || total[1].frames > total[0].frames) {
+    printf("FAIL: %s: the template sends more than MAX7219.C\n", name);
+    CheckFailed = 1;
+  }
+  if (ns[1] > ns[0] * (100 + CHECK_SLOWER_PCT) / 100) {
+    printf("FAIL: %s: the template takes %.0f ns per call, MAX7219.C %.0f ns\n", name, ns[1], ns[0]);
+    CheckFailed = 1;
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* CheckTime()
+*
+* Description: Time the body of a case on both drivers: CHECK_ROUNDS runs of calls * CHECK_REPEAT
+*              calls each, from initialised chips, the drivers taking turns.
+* Arguments  : ns = host nanoseconds per call of the best run, MAX7219.C then the template
+* Returns    : none
+*********************************************************************************************************
+*/
+static void CheckTime (void (*setup)(int, unsigned long), void (*body)(int, unsigned long),
+                       unsigned long calls, double *ns) {
+  struct timespec start, stop;
+  double run;
+  unsigned long i;
+  int round, tpl;
+
+  for (round = 0; round < CHECK_ROUNDS; round++) {
+    for (tpl = 0; tpl < 2; tpl++) {
+      MAX7219SimReset(MAX7219_CHAIN_MAX);
+      tpl ? Display.Init() : MAX7219Init();
+      CheckDigit = '0';
+      run = 0;
+      for (i = 0; i < calls * CHECK_REPEAT; i++) {
+        setup(tpl, i);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        body(tpl, i);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        run += (stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec);
+      }
+      run /= calls * CHECK_REPEAT;
+      if (round == 0 || run < ns[tpl])
+        ns[tpl] = run;
+    }
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* CheckRead()
+*
+* Description: Read the simulator's bus counters.
+*********************************************************************************************************
+*/
+static void CheckRead (struct check_count *count) {
+  count->pins   = MAX7219SimPinWrites();
+  count->clocks = MAX7219SimClocks();
+  count->frames = MAX7219SimFrames();
+  count->writes = MAX7219SimWrites();
+}
@@ -0,0 +1,95 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_TPLSIZE.CPP
+* Description: Code size of the C++ template driver (MAX7219.HPP) against MAX7219.C (host build).
+*
+*  A program that makes the calls of host/max7219_tplcheck.cpp once each, built three times:
+*  -DTPLSIZE_DRIVER=0 without a driver, 1 with MAX7219.C, 2 with a Max7219<> on the same pins.
+*  Unused functions are dropped at link time, so the text, data and bss of builds 1 and 2 less those
+*  of build 0 are what the calls cost in each driver:
+*
+*    for f in max7219.c max7219_chain.c max7219_shadow.c max7219_font.c max7219_text.c \
+*             max7219_matrix.c max7219_scroll.c max7219_queue.c max7219_buffer.c max7219_sched.c \
+*             max7219_fade.c max7219_ambient.c max7219_anim.c max7219_stats.c host/host_io.c \
+*             host/max7219_sim.c host/max7219_mock.c host/max7219_capture.c; do
+*      gcc -std=gnu99 -Os -ffunction-sections -fdata-sections -Ihost -I. -c $f
+*    done
+*    for d in 0 1 2; do
+*      g++ -std=gnu++11 -Os -ffunction-sections -fdata-sections -Wl,--gc-sections -Ihost -I. \
+*          -DTPLSIZE_DRIVER=$d -o max7219_tplsize$d *.o host/max7219_tplsize.cpp
+*    done
+*    size max7219_tplsize0 max7219_tplsize1 max7219_tplsize2
+*
+*  MAX7219.C brings its automatic power modes and statistics along, which the template does not
+*  have.  The sizes are those of the host CPU; the ATmega and UC3L sizes need avr-size and
+*  avr32-size on the same three builds.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.hpp"
+
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+#ifndef TPLSIZE_DRIVER
+#define TPLSIZE_DRIVER    2
+#endif
+
+#if TPLSIZE_DRIVER == 2
+typedef Max7219Pins<Max7219AvrPin<Max7219PortC, 0>,   // the pins of MAX7219.C
+                    Max7219AvrPin<Max7219PortC, 2>,
+                    Max7219AvrPin<Max7219PortC, 1> > SizePins;
+static Max7219<SizePins, MAX7219_CHAIN_MAX> Display;
+#endif
+
+static volatile char SizeInput = '8';                 // keeps the arguments from being folded
+
+
+/*
+*********************************************************************************************************
+* main()
+*********************************************************************************************************
+*/
+int main (void) {
+  char c = SizeInput;
+
+#if TPLSIZE_DRIVER == 1
+  MAX7219Init();
+  MAX7219Write(REG_DIGIT0 + (c & 7), c);
+  MAX7219WriteAll(REG_DIGIT0 + (c & 7), c);
+  MAX7219Clear();
+  MAX7219DisplayChar(c & 7, c, SEG_DP);
+  MAX7219SetBrightness(c);
+  MAX7219DisplayString(c & 7, "12.34 Ab");
+  MAX7219Flush();
+#elif TPLSIZE_DRIVER == 2
+  Display.Init();
+  Display.Write(0, REG_DIGIT0 + (c & 7), c);
+  Display.WriteAll(REG_DIGIT0 + (c & 7), c);
+  Display.Clear(0);
+  Display.DisplayChar(0, c & 7, c, SEG_DP);
+  Display.SetBrightness(0, c);
+  Display.DisplayString(0, c & 7, "12.34 Ab");
+  Display.Flush();
+#else
+  PORTC = c;                                          // the host PORTC stand-in, which both drivers use
+#endif
+  HostIoSync();
+  return 0;
+}
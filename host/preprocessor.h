@@ -0,0 +1,11 @@
+/*
+*********************************************************************************************************
+* Module     : PREPROCESSOR.H (host)
+* Description: Host stand-in for the AVR32 Software Framework's preprocessor.h.
+*********************************************************************************************************
+*/
+
+#ifndef _HOST_PREPROCESSOR_H
+#define _HOST_PREPROCESSOR_H
+
+#endif // _HOST_PREPROCESSOR_H
@@ -0,0 +1,14 @@
+/*
+*********************************************************************************************************
+* Module     : UTIL/DELAY.H (host)
+* Description: Host stand-in for <util/delay.h>; delays return immediately.
+*********************************************************************************************************
+*/
+
+#ifndef _HOST_UTIL_DELAY_H
+#define _HOST_UTIL_DELAY_H
+
+#define _delay_ms(ms)     ((void)(ms))
+#define _delay_us(us)     ((void)(us))
+
+#endif // _HOST_UTIL_DELAY_H
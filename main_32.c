@@ -17,10 +17,23 @@
 // and the synchronous clocks used to clock the main digital logic are handled
 // by the PM module.
 #include "power_clocks_lib.h"
+#include "intc.h"
 #endif
 
 #include "max7219.h"
 
+#define EXAMPLE_TICK_HZ               50              // scheduler ticks per second
+
+// Fade between brightness 3 and 15 over 1 second; runs every 2 seconds.
+static void brightness_toggle(void)
+{
+    static const unsigned char brightness_levels[2] = {3,15};
+    static unsigned char index = 0;
+
+    index = index ^ 1;
+    MAX7219Fade(brightness_levels[index], EXAMPLE_TICK_HZ);
+}
+
 static void fcpu_fpba_configure()
 {
 #if UC3L
@@ -57,28 +70,25 @@ int main(void) {
 	// GPIO module has to run at the CPU clock frequency when local bus transfers
 	// are being performed => we want fPBA = fCPU.
 	fcpu_fpba_configure();
+#if UC3L
+	INTC_init_interrupts();                // the scheduler's timer interrupt
+#endif
+
+	MAX7219Init();                         // auto power scans digits 1-5 only
 
-	MAX7219Init();
-	MAX7219Write(REG_SCAN_LIMIT, 5);       // 5 digit scan
+	// Light up the display once; from then on only the brightness changes,
+	// every 2 seconds, between 3 and 15 alternatively.  The CPU sleeps between ticks.
+	MAX7219DisplayChar(1, 'A', 0x80);
+	MAX7219DisplayChar(2, 'B', 0x80);
+	MAX7219DisplayL123(L1 | L2 | L3);
+	MAX7219DisplayChar(4, 'C', 0x80);
+	MAX7219DisplayChar(5, 'D', 0x80);
+	MAX7219Fade(3, 0);
+	MAX7219SchedAdd(brightness_toggle, 2 * EXAMPLE_TICK_HZ);
+	MAX7219SchedAdd(MAX7219FadeTick, 1);
+	MAX7219SchedInit(EXAMPLE_TICK_HZ);
 
-	// Loop forever and display all segments with brightness of
-	// 3 and 15 alternatively.
-	unsigned char brightness_levels[2] = {3,15};
-	unsigned char index = 0;
-	int count = 0;
-	while (1) {
-      // No button pressed.  Light up everything on the display.
-	  count++;
-	  if (count >= 32767) {
-	    index = index ^ 1;
-	    count = 0;
-	  }
-	  MAX7219SetBrightness(brightness_levels[index]);
-      MAX7219DisplayChar(1, 'A', 0x80);
-	  MAX7219DisplayChar(2, 'B', 0x80);
-	  MAX7219DisplayL123(L1 | L2 | L3);
-	  MAX7219DisplayChar(4, 'C', 0x80);
-	  MAX7219DisplayChar(5, 'D', 0x80);
-	}
+	while (1)
+	  MAX7219SchedRun();                   // only changed registers go out
 	return 0;
 }
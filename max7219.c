@@ -7,7 +7,8 @@
 *  allows the program to display more than the 0-9,H,E,L,P that code B provides.  However,
 *  the "no decode" method requires that each character to be displayed have a corresponding
 *  entry in a lookup table, to convert the ascii character to the proper 7-segment code.
-*  If you need to display more than the characters, simply add them to the table.
+*  The table is shared by both ports and lives in MAX7219_FONT.C.  Digits that only ever show
+*  numbers can be switched to code B with MAX7219SetDecodeMask(); they then skip the table.
 *
 *  Please see the datasheet for more details.
 *
@@ -30,11 +31,10 @@
 * Include Header Files
 *********************************************************************************************************
 */
-#include <ctype.h>
 #include <avr/io.h>                                   // microcontroller header file
-#include <avr/pgmspace.h>
 #include <util/delay.h>
 #include "max7219.h"                                  // MAX7219 header file
+#include "max7219_font.h"                             // 7-segment font table
 
 
 /********************************************************************************************************
@@ -66,105 +66,92 @@
 #define LOAD_0()      (LOAD_PORT &= ~LOAD_BIT)
 #define LOAD_1()      (LOAD_PORT |=  LOAD_BIT)
 
-/*
-*********************************************************************************************************
-* LED Segments:         a
-*                     ----
-*                   f|    |b
-*                    |  g |
-*                     ----
-*                   e|    |c
-*                    |    |
-*                     ----  o dp
-*                       d
-*   Register bits:
-*      bit:  7  6  5  4  3  2  1  0
-*           dp  a  b  c  d  e  f  g
-*
-* NOTES:
-* -You can define more patterns here and use PROGMEM to store the patterns into the flash to save
-*  SRAM!
-*********************************************************************************************************
-*/
-const uint8_t SegmentData[] PROGMEM = {
-  0b00000000,  // space
-  0b00000110,  // !
-  0b10001000,  // "
-  0b11101000,  // #
-  0b00011101,  // $
-  0b01011100,  // %
-  0b10111101,  // &
-  0b00001000,  // ' (single quote)
-  0b00111100,  // (, left-parenthesis
-  0b11010100,  // ), right-parenthesis
-  0b10001101,  // *
-  0b00101001,  // +
-  0b01010000,  // ,
-  0b00000001,  // -
-  0x80,  // . or dp
-  0b10000001,  // /
-  0x7e,  // 0
-  0x30,  // 1
-  0x6d,  // 2
-  0x79,  // 3
-  0x33,  // 4
-  0x5B,  // 5
-  0x5F,  // 6
-  0x70,  // 7
-  0x7F,  // 8
-  0x7B,  // 9
-  0b00010001,  // :
-  0b01010001,  // ;
-  0b00001101,  // <
-  0b00000101,  // =
-  0b10000101,  // >
-  0b10100101,  // ?
-  0b11110101,  // @
-  0x77,  // A
-  0x1F,  // B
-  0x4E,  // C
-  0x3D,  // D
-  0x4F,  // E
-  0x47,  // F
-  0b01111100,  // G
-  0b01101001,  // H
-  0b00101000,  // I
-  0b11110000,  // J
-  0b01101101,  // K
-  0b00111000,  // L
-  0b01100100,  // M
-  0b11101100,  // N
-  0b11111100,  // O
-  0b10101101,  // P
-  0b11001101,  // Q
-  0b10101100,  // R
-  0b01011101,  // S
-  0b00111001,  // T
-  0b11111000,  // U
-  0b11011000,  // V
-  0b10011000,  // W
-  0b11101001,  // X
-  0b11011001,  // Y
-  0b10010101,  // Z
-  0b00111100,  // [
-  0b00001001,  // \ back slash
-  0b11010100,  // ]
-  0b10001100,  // ^
-  0b00010000,  // _
-};
+/********************************************************************************************************
+* Transport
+
+  MAX7219_TRANSPORT (see MAX7219.H) selects how DATA and CLK are driven.  LOAD always stays on the
+  port pin above.
+
+  BITBANG : DATA/CLK on PC0/PC2 as above; every edge is a read-modify-write of PORTC.
+  SPI     : PB3 (MOSI) -> pin 1 (DIN), PB5 (SCK) -> pin 13 (CLK), fosc/2.  PB2 (SS) is driven as
+            an output so the SPI cannot drop out of master mode.
+  USART   : USART0 in master SPI mode (ATmega328 only, the ATmega8 USART has no MSPIM),
+            PD1 (TXD) -> DIN, PD4 (XCK) -> CLK, fosc/2.  The transmit buffer lets the data byte
+            follow the register byte without a gap.
+  MOCK    : host build; bytes and LOAD edges go to host/max7219_mock.c.
+  PARALLEL: MAX7219_PARALLEL_LINES chains (see MAX7219.H), chain n on DATA pin PDn, all sharing
+            CLK on PC2 and LOAD on PC1.  The words of a frame are collected, then transposed so
+            that each CLK pulse is one write of PORTD carrying the next bit of every chain, so all
+            chains are updated in the time of one.  PORTD pins above the chains keep their level
+            (nothing else may change them during a frame).
+
+  SPI and USART also drive MAX7219FlushAsync(): the transfer complete interrupt (SPI_STC_vect or
+  USART_TX_vect) sends the next byte and pulses LOAD at the end of each frame.
+
+  Estimated cost of one MAX7219Write() at 16 MHz:
+    BITBANG  ~460 cycles (29 us)  -- ~27 cycles per bit, the variable shift for the mask dominates
+    SPI       ~70 cycles (4.4 us) -- 16 cycles per byte on the wire plus polling SPIF
+    USART     ~55 cycles (3.4 us) -- both bytes back to back, one wait for TXC0
+    PARALLEL ~5 cycles per bit on the wire plus ~32 per byte and chain to transpose, e.g. ~520 cycles
+             (33 us) for a word to each of 4 chains against ~1840 sent one chain after another
+********************************************************************************************************/
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI || MAX7219_TRANSPORT == MAX7219_TRANSPORT_USART
+#include <avr/interrupt.h>                            // transfer complete drives MAX7219FlushAsync()
+#endif
+
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI
+#define SPI_DDR       DDRB
+#define SPI_MOSI_BIT  0x08                            // PB3
+#define SPI_SCK_BIT   0x20                            // PB5
+#define SPI_SS_BIT    0x04                            // PB2
+#define TX_WAIT()                                     // MAX7219SendByte() waits for SPIF itself
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_USART
+#define XCK_DDR       DDRD
+#define XCK_BIT       0x10                            // PD4
+#define TX_WAIT()     do { } while (!(UCSR0A & _BV(TXC0)))   // last bit has left the shifter
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+#include "max7219_mock.h"
+#undef  LOAD_0
+#undef  LOAD_1
+#define LOAD_0()      MAX7219MockLoad(0)
+#define LOAD_1()      MAX7219MockLoad(1)
+#define TX_WAIT()
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_LOCALBUS
+#error "MAX7219_TRANSPORT_LOCALBUS is only available on the UC3L (MAX7219_32.C)"
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+#if MAX7219_PARALLEL_LINES < 1 || MAX7219_PARALLEL_LINES > 8 || \
+    MAX7219_CHAIN_MAX % MAX7219_PARALLEL_LINES
+#error "MAX7219_PARALLEL_LINES must be 1-8 and divide MAX7219_CHAIN_MAX"
+#endif
+#define PARALLEL_PORT PORTD                           // chain n on PD.n
+#define PARALLEL_DDR  DDRD
+#define PARALLEL_MASK ((uint8_t)((1 << MAX7219_PARALLEL_LINES) - 1))
+#define TX_WAIT()     MAX7219ParallelSend()           // the frame goes out at the latch
+#else
+#define TX_WAIT()
+#endif
 
 /*
 *********************************************************************************************************
 * Private Data
 *********************************************************************************************************
 */
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+static unsigned char MAX7219ParallelFrame[2 * MAX7219_CHAIN_MAX];  // frame, farthest chip first
+static unsigned char MAX7219ParallelLength;           // bytes collected
+#endif
 
 /*
 *********************************************************************************************************
 * Private Function Prototypes
 *********************************************************************************************************
 */
+static void MAX7219TransportInit (void);
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+static void MAX7219ParallelSend (void);
+#else
 static void MAX7219SendByte (unsigned char data);
+#endif
 
 
 // ...................................... Public Functions ..............................................
@@ -180,33 +167,73 @@ static void MAX7219SendByte (unsigned char data);
 *********************************************************************************************************
 */
 void MAX7219Init (void) {
-  DATA_DDR |= DATA_BIT;                               // configure "DATA" as output
-  CLK_DDR  |= CLK_BIT;                                // configure "CLK"  as output
+  unsigned char i;
+
+  MAX7219TransportInit();                             // configure "DATA" and "CLK"
   LOAD_DDR |= LOAD_BIT;                               // configure "LOAD" as output
 
-  MAX7219Write(REG_SCAN_LIMIT, 7);                   // set up to scan all eight digits
-  MAX7219Write(REG_DECODE, 0x00);                    // set to "no decode" for all digits
-  MAX7219ShutdownStop();                             // select normal operation (i.e. not shutdown)
-  MAX7219DisplayTestStop();                          // select normal operation (i.e. not test mode)
-  MAX7219Clear();                                    // clear all digits
-  MAX7219SetBrightness(INTENSITY_MAX);               // set to maximum intensity
+  MAX7219Invalidate();                               // chip state is unknown: send everything
+  MAX7219SetRegisterAll(REG_SCAN_LIMIT, 7);          // set up to scan all eight digits
+  MAX7219SetRegisterAll(REG_DECODE, 0x00);           // set to "no decode" for all digits
+  MAX7219SetRegisterAll(REG_SHUTDOWN, 1);            // select normal operation (i.e. not shutdown)
+  MAX7219SetRegisterAll(REG_DISPLAY_TEST, 0);        // select normal operation (i.e. not test mode)
+  for (i = REG_DIGIT0; i < REG_DIGIT0 + 8; i++)
+    MAX7219SetRegisterAll(i, 0x00);                  // clear all digits
+  MAX7219SetRegisterAll(REG_INTENSITY, INTENSITY_MAX); // set to maximum intensity
+  MAX7219Flush();                                    // one frame per register for the whole chain
 }
 
 
 /*
 *********************************************************************************************************
-* MAX7219Write()
+* MAX7219FrameStart()
 *
-* Description: Write to MAX7219
-* Arguments  : reg_number = register to write to, basically the digit id, 0-7.
-*              dataout = data to write to MAX7219
+* Description: Begin a LOAD frame.  Follow with one MAX7219FrameWord() per chip in the chain, farthest
+*              chip first, then MAX7219FrameLatch().
+* Arguments  : none
 * Returns    : none
 *********************************************************************************************************
 */
-void MAX7219Write (unsigned char reg_number, unsigned char dataout) {
+void MAX7219FrameStart (void) {
   LOAD_1();                                           // take LOAD high to begin
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+  MAX7219ParallelLength = 0;
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FrameWord()
+*
+* Description: Shift one register/data pair into the chain.
+* Arguments  : reg_number = register to write to (REG_NOOP for chips that are not addressed)
+*              dataout = data to write to MAX7219
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219FrameWord (unsigned char reg_number, unsigned char dataout) {
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+  MAX7219ParallelFrame[MAX7219ParallelLength++] = reg_number;  // sent by MAX7219FrameLatch()
+  MAX7219ParallelFrame[MAX7219ParallelLength++] = dataout;
+#else
   MAX7219SendByte(reg_number);                        // write register number to MAX7219
   MAX7219SendByte(dataout);                           // write data to MAX7219
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FrameLatch()
+*
+* Description: End a LOAD frame; every chip latches the word in its shift register.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219FrameLatch (void) {
+  TX_WAIT();                                          // let the transport finish shifting
   LOAD_0();                                           // take LOAD low to latch in data
   LOAD_1();                                           // take LOAD high to end
 }
@@ -222,7 +249,7 @@ void MAX7219Write (unsigned char reg_number, unsigned char dataout) {
 *********************************************************************************************************
 */
 void MAX7219ShutdownStart (void) {
-  MAX7219Write(REG_SHUTDOWN, 0);                     // put MAX7219 into "shutdown" mode
+  MAX7219SetRegister(REG_SHUTDOWN, 0);               // put MAX7219 into "shutdown" mode
 }
 
 
@@ -236,7 +263,7 @@ void MAX7219ShutdownStart (void) {
 *********************************************************************************************************
 */
 void MAX7219ShutdownStop (void) {
-  MAX7219Write(REG_SHUTDOWN, 1);                     // put MAX7219 into "normal" mode
+  MAX7219SetRegister(REG_SHUTDOWN, 1);               // put MAX7219 into "normal" mode
 }
 
 
@@ -250,7 +277,7 @@ void MAX7219ShutdownStop (void) {
 *********************************************************************************************************
 */
 void MAX7219DisplayTestStart (void) {
-  MAX7219Write(REG_DISPLAY_TEST, 1);                 // put MAX7219 into "display test" mode
+  MAX7219SetRegister(REG_DISPLAY_TEST, 1);           // put MAX7219 into "display test" mode
 }
 
 
@@ -264,7 +291,7 @@ void MAX7219DisplayTestStart (void) {
 *********************************************************************************************************
 */
 void MAX7219DisplayTestStop (void) {
-  MAX7219Write(REG_DISPLAY_TEST, 0);                 // put MAX7219 into "normal" mode
+  MAX7219SetRegister(REG_DISPLAY_TEST, 0);           // put MAX7219 into "normal" mode
 }
 
 
@@ -279,7 +306,7 @@ void MAX7219DisplayTestStop (void) {
 */
 void MAX7219SetBrightness (char brightness) {
   brightness &= 0x0f;                                // mask off extra bits
-  MAX7219Write(REG_INTENSITY, brightness);           // set brightness
+  MAX7219SetRegister(REG_INTENSITY, brightness);     // set brightness
 }
 
 
@@ -293,9 +320,9 @@ void MAX7219SetBrightness (char brightness) {
 *********************************************************************************************************
 */
 void MAX7219Clear (void) {
-  char i;
-  for (i=0; i < 8; i++)
-    MAX7219Write(i, 0x00);                           // turn all segments off
+  unsigned char i;
+  for (i = REG_DIGIT0; i < REG_DIGIT0 + 8; i++)
+    MAX7219SetRegister(i, 0x00);                     // turn all segments off
 }
 
 
@@ -305,15 +332,19 @@ void MAX7219Clear (void) {
 *
 * Description: Display a character on the specified digit.
 * Arguments  : digit = digit number (1-8)
-*              character = character to display (0-9, A-Z, etc.)
-*              setDot = 0x80 to enable the digit's decimal dot. 0x00 not to enable.
-* Returns    : none
+*              character = character to display (' '..'~'; anything else shows blank).  On a digit
+*                          in Code-B mode (see MAX7219SetDecodeMask()) only '0'-'9', '-', E, H, L, P.
+*              setDot = nonzero (e.g. SEG_DP) to enable the digit's decimal dot. 0x00 not to enable.
+* Returns    : none; a digit outside 1-8 is ignored
 *********************************************************************************************************
 */
 void MAX7219DisplayChar (char digit, char character, uint8_t setDot) {
-  character = toupper(character);
-  uint8_t byte = pgm_read_byte(&SegmentData[character - 32]);
-  MAX7219Write(digit, byte | setDot);
+  if (digit < 1 || digit > 8)
+    return;
+  if (MAX7219GetRegister(REG_DECODE) & (1 << (digit - 1)))
+    MAX7219SetRegister(digit, MAX7219FontCodeB(character) | (setDot ? CODEB_DP : 0));  // chip decodes
+  else
+    MAX7219SetRegister(digit, MAX7219FontGlyph(character) | (setDot ? SEG_DP : 0));
 }
 
 /*
@@ -322,15 +353,111 @@ void MAX7219DisplayChar (char digit, char character, uint8_t setDot) {
 *
 * Description: Display the colon and/or degree dots
 * Arguments  : bit = L1/L2/L3 constants can be OR'ed together to display any of the dots of the colon
-*              or the degree dot.
+*              or the degree dot.  They are wired to segments C, B and A of digit 3.
 * Returns    : none
 *********************************************************************************************************
 */
 void MAX7219DisplayL123(char bits) {
-  MAX7219Write(3, bits << 4);
+  MAX7219SetRegister(3, ((bits & L1) ? SEG_C : 0) |  // through SEG_x, so a board wiring applies
+                        ((bits & L2) ? SEG_B : 0) |
+                        ((bits & L3) ? SEG_A : 0));
 }	
 
+#if MAX7219_TRANSPORT_IRQ
+/*
+*********************************************************************************************************
+* MAX7219FrameSendAsync()
+*
+* Description: Start sending a frame in the background.  The transfer complete interrupt sends the
+*              remaining bytes, pulses LOAD and calls MAX7219AsyncFrameDone().
+* Arguments  : frame = bytes to send, farthest chip first; must stay valid until the frame is latched
+*              len = number of bytes (two per chip)
+* Returns    : none
+*********************************************************************************************************
+*/
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+void MAX7219FrameSendAsync (const unsigned char *frame, unsigned char len) {
+  MAX7219MockSendAsync(frame, len);                   // host/max7219_mock.c plays the interrupt
+}
+#else
+static const unsigned char *MAX7219TxNext;            // next byte for the interrupt handler
+static volatile unsigned char MAX7219TxLeft;          // bytes the interrupt handler still has to send
+
+void MAX7219FrameSendAsync (const unsigned char *frame, unsigned char len) {
+  MAX7219TxNext = frame + 1;
+  MAX7219TxLeft = len - 1;
+  LOAD_1();                                           // take LOAD high to begin
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI
+  SPCR |= _BV(SPIE);
+  SPDR = frame[0];
+#else
+  UCSR0B |= _BV(TXCIE0);
+  UDR0 = frame[0];
+#endif
+}
+
+
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI
+ISR(SPI_STC_vect) {
+  if (MAX7219TxLeft) {
+    MAX7219TxLeft--;
+    SPDR = *MAX7219TxNext++;                          // next byte of the frame
+    return;
+  }
+  SPCR &= ~_BV(SPIE);                                 // back to polled mode between frames
+  LOAD_0();                                           // take LOAD low to latch in data
+  LOAD_1();                                           // take LOAD high to end
+  MAX7219AsyncFrameDone();
+}
+#else
+ISR(USART_TX_vect) {
+  if (MAX7219TxLeft) {
+    MAX7219TxLeft--;
+    UDR0 = *MAX7219TxNext++;                          // next byte of the frame
+    return;
+  }
+  UCSR0B &= ~_BV(TXCIE0);                             // back to polled mode between frames
+  LOAD_0();                                           // take LOAD low to latch in data
+  LOAD_1();                                           // take LOAD high to end
+  MAX7219AsyncFrameDone();
+}
+#endif
+#endif
+#endif
+
 // ..................................... Private Functions ..............................................
+/*
+*********************************************************************************************************
+* MAX7219TransportInit()
+*
+* Description: Set up the pins or the peripheral that shift frames out to the MAX7219.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+static void MAX7219TransportInit (void) {
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI
+  SPI_DDR |= SPI_MOSI_BIT | SPI_SCK_BIT | SPI_SS_BIT;  // MOSI, SCK and SS as outputs
+  SPCR = _BV(SPE) | _BV(MSTR);                        // master, mode 0, MSB first
+  SPSR = _BV(SPI2X);                                  // fosc/2
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_USART
+  UBRR0 = 0;
+  XCK_DDR |= XCK_BIT;                                 // XCK as output selects master mode
+  UCSR0C = _BV(UMSEL01) | _BV(UMSEL00);               // MSPIM, mode 0, MSB first
+  UCSR0B = _BV(TXEN0);                                // transmitter only
+  UBRR0 = 0;                                          // fosc/2; set after enabling, per datasheet
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+                                                      // nothing to set up on the host
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+  PARALLEL_DDR |= PARALLEL_MASK;                      // one "DATA" output per chain
+  CLK_DDR      |= CLK_BIT;                            // configure "CLK"  as output
+#else
+  DATA_DDR |= DATA_BIT;                               // configure "DATA" as output
+  CLK_DDR  |= CLK_BIT;                                // configure "CLK"  as output
+#endif
+}
+
+
 /*
 *********************************************************************************************************
 * MAX7219SendByte()
@@ -340,6 +467,26 @@ void MAX7219DisplayL123(char bits) {
 * Returns    : none
 *********************************************************************************************************
 */
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI
+static void MAX7219SendByte (unsigned char dataout) {
+  SPDR = dataout;                                     // start the transfer
+  while (!(SPSR & _BV(SPIF)))                         // wait until all 8 bits are out
+    ;
+}
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_USART
+static void MAX7219SendByte (unsigned char dataout) {
+  while (!(UCSR0A & _BV(UDRE0)))                      // wait for room in the transmit buffer
+    ;
+  UCSR0A = _BV(TXC0);                                 // clear "transmit complete" (write one)
+  UDR0 = dataout;
+}
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+static void MAX7219SendByte (unsigned char dataout) {
+  MAX7219MockSendByte(dataout);
+}
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+                                                      // frames go out in MAX7219ParallelSend()
+#else
 static void MAX7219SendByte (unsigned char dataout) {
   char i;
   for (i=8; i>0; i--) {
@@ -352,3 +499,45 @@ static void MAX7219SendByte (unsigned char dataout) {
     CLK_1();                                          // bring CLK high
   }
 }
+#endif
+
+
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+/*
+*********************************************************************************************************
+* MAX7219ParallelSend()
+*
+* Description: Shift the collected frame out on every chain at once.  Chain n holds chips
+*              n * P to n * P + P - 1 (P chips per chain), so its bytes are a slice of the frame,
+*              farthest chip first.  For each byte position the bytes of all chains are transposed
+*              into 8 port values, MSB first, bit n for chain n.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+static void MAX7219ParallelSend (void) {
+  unsigned char per_line = MAX7219ParallelLength / MAX7219_PARALLEL_LINES;  // bytes per chain
+  uint8_t keep = PARALLEL_PORT & (uint8_t)~PARALLEL_MASK;  // the other PORTD pins
+  uint8_t slice[8], data;
+  unsigned char pos, line, bit;
+  const unsigned char *p;
+
+  for (pos = 0; pos < per_line; pos++) {
+    for (bit = 0; bit < 8; bit++)
+      slice[bit] = 0;
+    p = &MAX7219ParallelFrame[pos];                   // the last chain's bytes come first
+    for (line = 0; line < MAX7219_PARALLEL_LINES; line++, p += per_line) {
+      data = *p;
+      for (bit = 0; bit < 8; bit++) {                 // last chain first: chain 0 ends up in bit 0
+        slice[bit] = (slice[bit] << 1) | (data >> 7);
+        data <<= 1;
+      }
+    }
+    for (bit = 0; bit < 8; bit++) {
+      CLK_0();                                        // bring CLK low
+      PARALLEL_PORT = keep | slice[bit];              // one bit for every chain
+      CLK_1();                                        // bring CLK high
+    }
+  }
+}
+#endif
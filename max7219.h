@@ -15,11 +15,73 @@
 #ifndef _MAX7219H
 #define _MAX7219H
 
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+*********************************************************************************************************
+* Configuration
+*
+*  MAX7219_TRANSPORT selects how frames are shifted out to the chip.  Define it on the compiler
+*  command line (e.g. -DMAX7219_TRANSPORT=MAX7219_TRANSPORT_SPI); the bit-banged pins are the default.
+*  The pins used by each transport are listed in MAX7219.C and MAX7219_32.C.
+*********************************************************************************************************
+*/
+#define MAX7219_TRANSPORT_BITBANG 0                   // software shift on three GPIO pins
+#define MAX7219_TRANSPORT_SPI     1                   // SPI peripheral (ATmega SPI, UC3L SPI)
+#define MAX7219_TRANSPORT_USART   2                   // ATmega328 USART0 in master SPI mode
+#define MAX7219_TRANSPORT_MOCK    3                   // host build; see host/max7219_mock.c
+#define MAX7219_TRANSPORT_LOCALBUS 4                  // UC3L GPIO on the CPU local bus, unrolled shift
+#define MAX7219_TRANSPORT_PARALLEL 5                  // ATmega: up to 8 chains, a DATA pin each on PORTD
+
+#ifndef MAX7219_TRANSPORT
+#define MAX7219_TRANSPORT MAX7219_TRANSPORT_BITBANG
+#endif
+
+// Transports with a peripheral that shifts on its own, so MAX7219FlushAsync() can run from its interrupt.
+#define MAX7219_TRANSPORT_IRQ (MAX7219_TRANSPORT != MAX7219_TRANSPORT_BITBANG && \
+                               MAX7219_TRANSPORT != MAX7219_TRANSPORT_LOCALBUS && \
+                               MAX7219_TRANSPORT != MAX7219_TRANSPORT_PARALLEL)
+
+// Number of MAX7219s cascaded DOUT->DIN.  Sizes the shadow registers (32 bytes of RAM per chip);
+// MAX7219SetChainLength() can use fewer at run time.
+#ifndef MAX7219_CHAIN_MAX
+#define MAX7219_CHAIN_MAX 1
+#endif
+
+// MAX7219_TRANSPORT_PARALLEL: the chain is split into MAX7219_PARALLEL_LINES separate chains of
+// equal length, all on the shared CLK and LOAD, each with its own DATA pin.  Address chip c of chain
+// n as MAX7219_PARALLEL_CHIP(n, c).  MAX7219SetChainLength() rounds the total up to a multiple of
+// MAX7219_PARALLEL_LINES.
+#ifndef MAX7219_PARALLEL_LINES
+#define MAX7219_PARALLEL_LINES MAX7219_CHAIN_MAX
+#endif
+#define MAX7219_PARALLEL_CHIP(line, chip) \
+  ((line) * (MAX7219GetChainLength() / MAX7219_PARALLEL_LINES) + (chip))
+
+// Registers the driver adjusts on its own (MAX7219SetAutoPower()).  The datasheet asks for a larger
+// RSET when three digits or fewer are scanned, so by default the scan limit does not go below 3
+// (four digits); boards built for it can lower MAX7219_AUTO_SCAN_MIN.
+#define MAX7219_AUTO_SCAN     0x01                    // scan only up to the last lit digit
+#define MAX7219_AUTO_SHUTDOWN 0x02                    // shut down while every digit is blank
+
+#ifndef MAX7219_AUTO_POWER
+#define MAX7219_AUTO_POWER    (MAX7219_AUTO_SCAN | MAX7219_AUTO_SHUTDOWN)
+#endif
+#ifndef MAX7219_AUTO_SCAN_MIN
+#define MAX7219_AUTO_SCAN_MIN 3
+#endif
+
 /*
 *********************************************************************************************************
 * Constants
 *********************************************************************************************************
 */
+#define REG_NOOP          0x00                        // "no-op" register
+#define REG_DIGIT0        0x01                        // first digit register (digits are 0x01-0x08)
 #define REG_DECODE        0x09                        // "decode mode" register
 #define REG_INTENSITY     0x0a                        // "intensity" register
 #define REG_SCAN_LIMIT    0x0b                        // "scan limit" register
@@ -33,6 +95,15 @@
 #define L1 0x01
 #define L2 0x02
 #define L3 0x04
+#define L_COLON (L1 | L2)                             // both dots of the colon
+
+// Digits used by MAX7219DisplayTime(): hh on the first two, the colon on digit 3, mm on 4 and 5.
+#ifndef MAX7219_TIME_HOURS
+#define MAX7219_TIME_HOURS    1
+#endif
+#ifndef MAX7219_TIME_MINUTES
+#define MAX7219_TIME_MINUTES  4
+#endif
 
 /*
 *********************************************************************************************************
@@ -48,5 +119,335 @@ void MAX7219SetBrightness (char brightness);
 void MAX7219Clear (void);
 void MAX7219DisplayChar (char digit, char character, uint8_t setDot);
 void MAX7219DisplayL123 (char bits);
+
+/*
+*********************************************************************************************************
+* Text Function Prototypes (MAX7219_TEXT.C)
+*
+*  Render a field of digits into the shadow registers of chip 0; MAX7219Flush() sends them.  Fields
+*  are given by their first (leftmost) digit and their width; numbers are right aligned.
+*
+*  MAX7219SetDecodeMask() puts the digits whose bit is set (bit 0 = digit 1) in the chip's Code-B
+*  decode mode: the driver then sends them the digit value itself and skips the font table.  Code-B
+*  shows 0-9, '-', E, H, L, P and blank only, and ignores segments a-g set directly, so the digit used
+*  by MAX7219DisplayL123() must stay in no-decode mode.
+*********************************************************************************************************
+*/
+void MAX7219DisplayString (char digit, const char *string);
+void MAX7219DisplayInt (char digit, char width, int32_t value);
+void MAX7219DisplayFixed (char digit, char width, int32_t value, char decimals);
+void MAX7219DisplayHex (char digit, char width, uint32_t value);
+void MAX7219DisplayTime (unsigned char hours, unsigned char minutes, unsigned char colon);
+void MAX7219SetDecodeMask (uint8_t mask);
+
+/*
+*********************************************************************************************************
+* Command Ring Function Prototypes (MAX7219_QUEUE.C)
+*
+*  Interrupt handlers (or other threads) queue register updates with MAX7219QueuePut() (one producer)
+*  or MAX7219QueuePutMulti() (any number of producers); the one context that owns the driver sends
+*  them with MAX7219QueueDrain().
+*********************************************************************************************************
+*/
+#ifndef MAX7219_QUEUE_SIZE
+#define MAX7219_QUEUE_SIZE    16                      // entries per ring, power of two, 4 bytes each
+#endif
+
+unsigned char MAX7219QueuePut (unsigned char chip, unsigned char reg_number, unsigned char data);
+unsigned char MAX7219QueuePutMulti (unsigned char chip, unsigned char reg_number, unsigned char data);
+unsigned int MAX7219QueueDrain (void);
+
+/*
+*********************************************************************************************************
+* Frame Buffer Function Prototypes (MAX7219_BUFFER.C)
+*
+*  Draw a frame into the back buffer with MAX7219BufferSet(), then show it in one burst with
+*  MAX7219BufferCommit(), or at the next MAX7219BufferTick() with MAX7219BufferCommitOnTick().
+*********************************************************************************************************
+*/
+void MAX7219BufferSet (unsigned char chip, char digit, uint8_t data);
+uint8_t MAX7219BufferGet (unsigned char chip, char digit);
+void MAX7219BufferClear (void);
+void MAX7219BufferCommit (void);
+void MAX7219BufferCommitOnTick (void);
+unsigned char MAX7219BufferPending (void);
+void MAX7219BufferTick (void);
+
+/*
+*********************************************************************************************************
+* Scroll Function Prototypes (MAX7219_SCROLL.C)
+*
+*  MAX7219ScrollTick() only updates the shadow registers; run it as a scheduler task, not from an
+*  interrupt.  See MAX7219_SCROLL.C.
+*********************************************************************************************************
+*/
+#ifndef MAX7219_SCROLL_MAX
+#define MAX7219_SCROLL_MAX    32                      // longest message, one byte of RAM per character
+#endif
+
+unsigned char MAX7219ScrollStart (char digit, char width, const char *message, unsigned char repeat);
+void MAX7219ScrollSetRate (unsigned int ticks);
+void MAX7219ScrollStop (void);
+unsigned char MAX7219ScrollRunning (void);
+void MAX7219ScrollTick (void);
+
+/*
+*********************************************************************************************************
+* Scheduler Function Prototypes (MAX7219_SCHED.C)
+*
+*  Register the display work with MAX7219SchedAdd(), then call MAX7219SchedRun() in the main loop: it
+*  sleeps until the next timer tick and runs the tasks that are due.  See MAX7219_SCHED.C.
+*********************************************************************************************************
+*/
+#ifndef MAX7219_SCHED_TASKS
+#define MAX7219_SCHED_TASKS   4                       // task slots, 6 bytes each on the ATmega
+#endif
+#ifndef MAX7219_SCHED_ISR
+#define MAX7219_SCHED_ISR     1                       // 0 = the application owns the timer ISR
+#endif
+
+void MAX7219SchedInit (unsigned int rate_hz);
+unsigned char MAX7219SchedAdd (void (*task)(void), unsigned int period);
+void MAX7219SchedRemove (void (*task)(void));
+void MAX7219SchedRun (void);
+void MAX7219SchedTick (void);
+uint32_t MAX7219SchedTime (void);
+
+/*
+*********************************************************************************************************
+* Fade Function Prototypes (MAX7219_FADE.C)
+*
+*  Fade the intensity along a gamma-corrected curve; MAX7219FadeTick() advances the fades, e.g. as a
+*  scheduler task.  See MAX7219_FADE.C.
+*********************************************************************************************************
+*/
+#define MAX7219_FADE_ANY  0xff                        // MAX7219FadeBusy(): any chip in the chain
+
+void MAX7219FadeChip (unsigned char chip, unsigned char intensity, unsigned int ticks);
+void MAX7219Fade (unsigned char intensity, unsigned int ticks);
+unsigned char MAX7219FadeBusy (unsigned char chip);
+void MAX7219FadeTick (void);
+
+/*
+*********************************************************************************************************
+* Ambient Light Function Prototypes (MAX7219_AMBIENT.C)
+*
+*  Optional: MAX7219AmbientTick(), run as a scheduler task, sets the intensity of the chain from a
+*  light sensor on the ADC.  See MAX7219_AMBIENT.C.
+*********************************************************************************************************
+*/
+#ifndef MAX7219_AMBIENT_SHIFT
+#define MAX7219_AMBIENT_SHIFT 4                       // filter time constant = 2^n ticks, n <= 6
+#endif
+#ifndef MAX7219_AMBIENT_HYST
+#define MAX7219_AMBIENT_HYST  24                      // readings past a step edge before it moves
+#endif
+
+void MAX7219AmbientInit (unsigned char min_intensity, unsigned char max_intensity);
+void MAX7219AmbientTick (void);
+uint16_t MAX7219AmbientLevel (void);
+
+/*
+*********************************************************************************************************
+* Animation Function Prototypes (MAX7219_ANIM.C)
+*
+*  Plays delta-encoded animations from flash, made with host/max7219_animenc.c; MAX7219AnimTick()
+*  advances them, e.g. as a scheduler task.  See MAX7219_ANIM.C for the format.
+*********************************************************************************************************
+*/
+#define MAX7219_ANIM_KEY      0x80                    // record head: keyframe, all 8 digits follow
+#define MAX7219_ANIM_HOLD     0x7f                    // record head: ticks the frame is shown
+#define MAX7219_ANIM_END      0xff                    // end of the animation
+
+#if defined(__AVR__) && !defined(__AVR32__)
+#include <avr/pgmspace.h>
+#define MAX7219_ANIM_ATTR     PROGMEM                 // where the animation bytes live
+#else
+#define MAX7219_ANIM_ATTR
+#endif
+
+void MAX7219AnimStart (const uint8_t *anim, unsigned char repeat);
+void MAX7219AnimStop (void);
+unsigned char MAX7219AnimRunning (void);
+void MAX7219AnimTick (void);
+
+/*
+*********************************************************************************************************
+* Statistics Function Prototypes (MAX7219_STATS.C)
+*
+*  Optional bus traffic counters (MAX7219_STATS = 1) and a ring of the last register words sent
+*  (MAX7219_TRACE_SIZE entries).  Both default to off; the driver then has no counting code and no
+*  data for them, and the functions below are not declared.  See MAX7219_STATS.C.
+*********************************************************************************************************
+*/
+#ifndef MAX7219_STATS
+#define MAX7219_STATS         0                       // 1 = count writes, frames, bits, blocking time
+#endif
+#ifndef MAX7219_TRACE_SIZE
+#define MAX7219_TRACE_SIZE    0                       // words kept, power of two <= 128; 0 = none
+#endif
+
+#if MAX7219_STATS
+struct max7219_stats {
+  uint32_t writes;                                    // register words sent (no-ops not counted)
+  uint32_t skipped;                                   // updates dropped: register already had the value
+  uint32_t frames;                                    // LOAD pulses
+  uint32_t bits;                                      // bits clocked out, no-ops included
+  uint32_t bytes_per_sec;                             // bytes clocked out in the last second
+  uint32_t write_max;                                 // longest direct write, in clock counts
+  uint32_t flush_max;                                 // longest MAX7219Flush(), in clock counts
+};
+
+void MAX7219StatsGet (struct max7219_stats *stats);
+void MAX7219StatsReset (void);
+void MAX7219StatsSecond (void);
+#endif
+
+#if MAX7219_TRACE_SIZE
+struct max7219_trace {
+  unsigned char chip;                                 // chip index
+  unsigned char reg_number;                           // register written
+  unsigned char data;                                 // value written
+};
+
+unsigned char MAX7219TraceGet (unsigned char age, struct max7219_trace *entry);
+#endif
+
+/*
+*********************************************************************************************************
+* Matrix Function Prototypes (MAX7219_MATRIX.C)
+*
+*  For 8x8 LED matrices: digit registers 1-8 are rows 0-7, segment bits 0-7 are columns 0-7.  Each
+*  chip's image is a 64-bit bitmap (byte y = row y).  The drawing functions change the image only;
+*  MAX7219MatrixShow() copies every image into the shadow registers and MAX7219Flush() sends it.
+*********************************************************************************************************
+*/
+#define MAX7219_MATRIX_ROT0    0x00                   // module mounted upright
+#define MAX7219_MATRIX_ROT90   0x01                   // turned a quarter clockwise
+#define MAX7219_MATRIX_ROT180  0x02
+#define MAX7219_MATRIX_ROT270  0x03
+#define MAX7219_MATRIX_MIRROR  0x04                   // columns reversed (applied before turning)
+
+void MAX7219MatrixSetOrientation (unsigned char chip, unsigned char orientation);
+void MAX7219MatrixSet (unsigned char chip, uint64_t image);
+uint64_t MAX7219MatrixGet (unsigned char chip);
+void MAX7219MatrixSetPixel (unsigned char chip, unsigned char x, unsigned char y, unsigned char on);
+unsigned char MAX7219MatrixGetPixel (unsigned char chip, unsigned char x, unsigned char y);
+void MAX7219MatrixFill (unsigned char chip, unsigned char on);
+void MAX7219MatrixInvert (unsigned char chip);
+void MAX7219MatrixShift (unsigned char chip, signed char dx, signed char dy);
+void MAX7219MatrixTranspose (unsigned char chip);
+void MAX7219MatrixMirror (unsigned char chip);
+void MAX7219MatrixFlip (unsigned char chip);
+void MAX7219MatrixRotate (unsigned char chip, unsigned char turns);
+void MAX7219MatrixShow (void);
+
+/*
+*********************************************************************************************************
+* Daisy Chain Function Prototypes (MAX7219_CHAIN.C)
+*
+*  Chip 0 is the one wired to the MCU; chip n-1 is the last one in the chain.  Every call below is a
+*  single LOAD frame: chips that are not addressed receive a no-op.  The display functions above and
+*  MAX7219Write() address chip 0.
+*********************************************************************************************************
+*/
+void MAX7219SetChainLength (unsigned char length);
+unsigned char MAX7219GetChainLength (void);
 void MAX7219Write (unsigned char reg_number, unsigned char data);
+void MAX7219WriteChip (unsigned char chip, unsigned char reg_number, unsigned char data);
+void MAX7219WriteAll (unsigned char reg_number, unsigned char data);
+
+/*
+*********************************************************************************************************
+* Shadow Register Function Prototypes (MAX7219_SHADOW.C)
+*
+*  The driver keeps a RAM copy of the digit, decode, intensity, scan limit, shutdown and display test
+*  registers of every chip.  The display functions above only update that copy; MAX7219Flush() then
+*  sends the registers whose value actually changed, one frame per register for the whole chain.
+*  MAX7219Write(), MAX7219WriteChip() and MAX7219WriteAll() go straight to the chips, except inside a
+*  transaction.
+*
+*  Unless MAX7219SetAutoPower() says otherwise, each flush also fits scan limit, intensity and shutdown
+*  of every chip to its lit digits (see MAX7219_SHADOW.C); the values the application sets act as the
+*  upper limits.
+*
+*  Between MAX7219Begin() and MAX7219Commit() nothing is sent: flushes are held back and the direct
+*  writes only update the shadow copy.  The commit then sends each changed register once, with its
+*  last value, one register of every chip per LOAD frame.
+*********************************************************************************************************
+*/
+void MAX7219SetRegister (unsigned char reg_number, unsigned char data);
+void MAX7219SetRegisterChip (unsigned char chip, unsigned char reg_number, unsigned char data);
+void MAX7219SetRegisterAll (unsigned char reg_number, unsigned char data);
+unsigned char MAX7219GetRegister (unsigned char reg_number);
+unsigned char MAX7219GetRegisterChip (unsigned char chip, unsigned char reg_number);
+unsigned char MAX7219GetWantedIntensity (unsigned char chip);
+void MAX7219Flush (void);
+void MAX7219Invalidate (void);
+void MAX7219SetAutoPower (unsigned char modes);
+void MAX7219Begin (void);
+void MAX7219Commit (void);
+unsigned char MAX7219InTransaction (void);
+
+/*
+*********************************************************************************************************
+* Asynchronous Flush Function Prototypes (MAX7219_SHADOW.C)
+*
+*  MAX7219FlushAsync() sends the first frame and returns; the transport interrupt (SPI/USART transfer
+*  complete on the ATmega, PDCA + SPI on the UC3L) sends the rest and calls done() from interrupt
+*  context once no dirty register is left.  Registers changed while the flush runs go out with it.
+*  Interrupts must be enabled.  With the bit-banged transports the flush runs before returning.
+*  MAX7219Flush() and the direct writes wait for a running asynchronous flush to finish.
+*********************************************************************************************************
+*/
+unsigned char MAX7219FlushAsync (void (*done)(void));
+unsigned char MAX7219FlushBusy (void);
+
+/*
+*********************************************************************************************************
+* Driver Internal Function Prototypes
+*
+*  Frame primitives provided by the port (MAX7219.C or MAX7219_32.C): MAX7219FrameStart(), then one
+*  MAX7219FrameWord() per chip, farthest chip first, then MAX7219FrameLatch().  Interrupt driven
+*  transports also provide MAX7219FrameSendAsync(), whose interrupt handler calls
+*  MAX7219AsyncFrameDone() after latching the frame.
+*********************************************************************************************************
+*/
+void MAX7219FrameStart (void);
+void MAX7219FrameWord (unsigned char reg_number, unsigned char data);
+void MAX7219FrameLatch (void);
+void MAX7219FrameSendAsync (const unsigned char *frame, unsigned char len);
+void MAX7219AsyncFrameDone (void);
+void MAX7219ShadowUpdate (unsigned char chip, unsigned char reg_number, unsigned char data);
+unsigned char MAX7219ShadowDeferrable (unsigned char reg_number);
+
+// Counting hooks in MAX7219_SHADOW.C and MAX7219_CHAIN.C; empty unless MAX7219_STATS.C is enabled.
+#if MAX7219_STATS || MAX7219_TRACE_SIZE
+void MAX7219StatsWord (unsigned char chip, unsigned char reg_number, unsigned char data);
+#define MAX7219_STATS_WORD(chip, reg_number, data)  MAX7219StatsWord(chip, reg_number, data)
+#else
+#define MAX7219_STATS_WORD(chip, reg_number, data)  ((void)0)
+#endif
+
+#if MAX7219_STATS
+#define MAX7219_STATS_WRITE   0                       // MAX7219StatsStop(): a direct write
+#define MAX7219_STATS_FLUSH   1                       // MAX7219StatsStop(): a flush
+
+void MAX7219StatsFrame (unsigned char bytes);
+void MAX7219StatsSkip (void);
+uint32_t MAX7219StatsStart (void);
+void MAX7219StatsStop (uint32_t start, unsigned char which);
+#define MAX7219_STATS_FRAME(bytes)  MAX7219StatsFrame(bytes)
+#define MAX7219_STATS_SKIP()        MAX7219StatsSkip()
+#define MAX7219_STATS_START()       uint32_t max7219_stats_start = MAX7219StatsStart()
+#define MAX7219_STATS_STOP(which)   MAX7219StatsStop(max7219_stats_start, which)
+#else
+#define MAX7219_STATS_FRAME(bytes)  ((void)0)
+#define MAX7219_STATS_SKIP()        ((void)0)
+#define MAX7219_STATS_START()
+#define MAX7219_STATS_STOP(which)   ((void)0)
+#endif
+#ifdef __cplusplus
+}
+#endif
 #endif // _MAX7219H
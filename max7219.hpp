@@ -0,0 +1,514 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219.HPP
+* Description: MAX7219 LED Display Driver as a header-only C++ template (ATmega, UC3L and host)
+*
+*  Max7219<Pins, ChainLength, Transport> is the driver of MAX7219.C and MAX7219_32.C with the pins,
+*  the chain length and the transport bound at compile time instead of by the macros in those files:
+*
+*    typedef Max7219Pins<Max7219AvrPin<Max7219PortC, 0>,        // DATA on PC0
+*                        Max7219AvrPin<Max7219PortC, 2>,        // CLK  on PC2
+*                        Max7219AvrPin<Max7219PortC, 1> > Board; // LOAD on PC1
+*    Max7219<Board, 2> display;                                 // two chips, bit-banged
+*
+*    display.Init();
+*    display.DisplayString(0, 1, "HELLO");
+*    display.Flush();
+*
+*  Every pin operation is a static inline function of a constant register and mask: on the ATmega
+*  (Max7219AvrPin) a single sbi or cbi, on the UC3L (Max7219LocalPin) a single store to the OVRS or
+*  OVRC register of the GPIO local bus mapping.  A display object holds nothing but its shadow
+*  registers (18 bytes per chip): no virtual functions and no heap, so any number of displays, each
+*  on its own pins, can live in one program, next to the C driver.
+*
+*  Transports:
+*    Max7219BitBang  DATA and CLK on two pins of Pins, MSB first (the default)
+*    Max7219AvrSpi   ATmega SPI, MOSI (PB3) -> DIN and SCK (PB5) -> CLK at fosc/2; PB2 (SS) is
+*                    driven as an output.  Pins::Data and Pins::Clk are not used.
+*
+*  Registers are kept as in MAX7219_SHADOW.C: SetRegister() updates a shadow copy, Flush() sends the
+*  changed registers, one per chip per LOAD frame, lowest register first.  Write() and WriteAll()
+*  send at once.  Registers go out as set: there are no automatic power modes (MAX7219SetAutoPower()).
+*
+*  Characters are converted with the font of MAX7219_FONT.H (and its SEG_x wiring).  Max7219Glyph()
+*  is constexpr, so a character known at compile time costs no table read; others are read from the
+*  table in flash.  Custom glyphs (MAX7219FontDefine()) belong to the C driver only.
+*
+*  Needs C++11 (-std=gnu++11; avr-g++ 4.7 or later).  host/max7219_tplcheck.cpp runs a display next
+*  to MAX7219.C on the host simulator and compares their bus traffic, results and time per call;
+*  host/max7219_tplsize.cpp compares their code size.  Both measure the host CPU, not the ATmega or
+*  the UC3L.  Max7219LocalPin has not been built for or run on a UC3L yet.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+#ifndef _MAX7219_HPP
+#define _MAX7219_HPP
+
+#if __cplusplus < 201103L
+#error "MAX7219.HPP needs C++11 (-std=gnu++11)"
+#endif
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include <stdint.h>
+#if defined(__AVR32__)
+#include "compiler.h"
+#include "gpio.h"                                     // GPIO driver and local bus registers
+#elif defined(__AVR__)
+#include <avr/io.h>                                   // microcontroller header file
+#else
+#include <avr/io.h>                                   // host stand-ins for both ports (host/)
+#include "gpio.h"
+#endif
+#include "max7219.h"                                  // register addresses
+#include "max7219_font.h"                             // SEG_x bits and MAX7219_FONT_GLYPHS
+
+
+/*
+*********************************************************************************************************
+* Font
+*********************************************************************************************************
+*/
+static constexpr uint8_t Max7219FontTable[FONT_LAST - FONT_FIRST + 1] FONT_ATTR = {
+  MAX7219_FONT_GLYPHS
+};
+
+/*
+*********************************************************************************************************
+* Max7219Glyph()
+*
+* Description: Convert a character to its 7-segment code at compile time.
+* Arguments  : character = character to display
+* Returns    : segment code, 0 (blank) for characters outside ' '..'~'
+*********************************************************************************************************
+*/
+static constexpr uint8_t Max7219Glyph (char character) {
+  return (uint8_t)(character - FONT_FIRST) <= FONT_LAST - FONT_FIRST ?
+         Max7219FontTable[(uint8_t)(character - FONT_FIRST)] : 0;
+}
+
+
+/*
+*********************************************************************************************************
+* Max7219GlyphRead()
+*
+* Description: Convert a character to its 7-segment code: folded at compile time for a constant,
+*              read from the table (in flash on the ATmega) otherwise.
+* Arguments  : character = character to display
+* Returns    : segment code, 0 (blank) for characters outside ' '..'~'
+*********************************************************************************************************
+*/
+static inline uint8_t Max7219GlyphRead (char character) {
+  uint8_t index = (uint8_t)(character - FONT_FIRST);  // characters below ' ' wrap to a large index
+
+  if (__builtin_constant_p(character))
+    return Max7219Glyph(character);
+  if (index > FONT_LAST - FONT_FIRST)
+    return 0;
+  return FONT_READ(&Max7219FontTable[index]);
+}
+
+
+/*
+*********************************************************************************************************
+* Pins
+*
+*  A pin type provides Output(), Set(), Clear(), Write(level) and Hold(), all static.  Hold() pads a
+*  DATA or CLK edge where the port is fast enough to outrun the MAX7219 (25 ns data setup, 50 ns CLK
+*  high and low).
+*********************************************************************************************************
+*/
+#if !defined(__AVR32__)
+// ATmega I/O ports: constant addresses, so |= and &= of a single bit compile to sbi and cbi.
+#define MAX7219_AVR_PORT(name, port, ddr)                                                   \
+  struct name {                                                                             \
+    static volatile uint8_t &Reg (void) { return port; }                                    \
+    static volatile uint8_t &Ddr (void) { return ddr; }                                     \
+  }
+MAX7219_AVR_PORT(Max7219PortB, PORTB, DDRB);
+MAX7219_AVR_PORT(Max7219PortC, PORTC, DDRC);
+MAX7219_AVR_PORT(Max7219PortD, PORTD, DDRD);
+
+template <class Port, uint8_t Bit>
+struct Max7219AvrPin {
+  static void Output (void)         { Port::Ddr() |= (uint8_t)(1 << Bit); }
+  static void Set (void)            { Port::Reg() |= (uint8_t)(1 << Bit); }
+  static void Clear (void)          { Port::Reg() &= (uint8_t)~(1 << Bit); }
+  static void Write (uint8_t level) { if (level) Set(); else Clear(); }
+  static void Hold (void)           { }             // sbi/cbi take 125 ns at 16 MHz
+};
+#endif
+
+#if defined(__AVR32__) || !defined(__AVR__)
+#ifndef MAX7219_LOCALBUS_HOLD
+#define MAX7219_LOCALBUS_HOLD()  __asm__ __volatile__ ("nop")  // enough up to 40 MHz, see MAX7219_32.C
+#endif
+
+// UC3L pin written through the GPIO local bus (needs fPBA = fCPU, see main_32.c).
+template <uint32_t Pin>
+struct Max7219LocalPin {
+  static void Output (void) {
+    gpio_local_init();                                // map the GPIO onto the CPU local bus
+    gpio_enable_gpio_pin(Pin);
+    gpio_local_enable_pin_output_driver(Pin);         // the PBA output enable does not apply
+  }
+  static void Set (void)            { AVR32_GPIO_LOCAL.port[Pin >> 5].ovrs = 1UL << (Pin & 0x1f); }
+  static void Clear (void)          { AVR32_GPIO_LOCAL.port[Pin >> 5].ovrc = 1UL << (Pin & 0x1f); }
+  static void Write (uint8_t level) { if (level) Set(); else Clear(); }
+  static void Hold (void)           { MAX7219_LOCALBUS_HOLD(); }
+};
+#endif
+
+template <class DataPin, class ClkPin, class LoadPin>
+struct Max7219Pins {
+  typedef DataPin Data;
+  typedef ClkPin  Clk;
+  typedef LoadPin Load;
+};
+
+
+/*
+*********************************************************************************************************
+* Transports
+*
+*  A transport provides Init<Pins>(), Send<Pins>(byte) and Wait(), all static.  Wait() returns once
+*  the last bit has left, before LOAD is pulsed.
+*********************************************************************************************************
+*/
+struct Max7219BitBang {
+  template <class Pins> static void Init (void) {
+    Pins::Data::Output();                             // configure "DATA" as output
+    Pins::Clk::Output();                              // configure "CLK"  as output
+  }
+  template <class Pins> static void Send (uint8_t dataout) {
+    uint8_t mask;
+    for (mask = 0x80; mask; mask >>= 1) {             // MSB first
+      Pins::Clk::Clear();                             // bring CLK low
+      Pins::Data::Write(dataout & mask);              // output one data bit
+      Pins::Data::Hold();
+      Pins::Clk::Set();                               // bring CLK high
+      Pins::Clk::Hold();
+    }
+  }
+  static void Wait (void) { }
+};
+
+#if defined(__AVR__) && !defined(__AVR32__)
+struct Max7219AvrSpi {
+  template <class Pins> static void Init (void) {
+    DDRB |= 0x08 | 0x20 | 0x04;                       // MOSI (PB3), SCK (PB5) and SS (PB2) as outputs
+    SPCR = _BV(SPE) | _BV(MSTR);                      // master, mode 0, MSB first
+    SPSR = _BV(SPI2X);                                // fosc/2
+  }
+  template <class Pins> static void Send (uint8_t dataout) {
+    SPDR = dataout;
+    while (!(SPSR & _BV(SPIF)))                       // 16 cycles on the wire
+      ;
+  }
+  static void Wait (void) { }
+};
+#endif
+
+
+/*
+*********************************************************************************************************
+* Max7219
+*
+*  Pins        = Max7219Pins<Data, Clk, Load>
+*  ChainLength = MAX7219s cascaded DOUT->DIN, chip 0 nearest the MCU
+*  Transport   = Max7219BitBang or Max7219AvrSpi
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength = 1, class Transport = Max7219BitBang>
+class Max7219 {
+  static_assert(ChainLength >= 1 && ChainLength <= 127, "ChainLength must be 1-127");
+
+public:
+  void Init (void);
+  void Write (uint8_t chip, uint8_t reg_number, uint8_t dataout);
+  void WriteAll (uint8_t reg_number, uint8_t dataout);
+  void SetRegister (uint8_t chip, uint8_t reg_number, uint8_t data);
+  void SetRegisterAll (uint8_t reg_number, uint8_t data);
+  uint8_t GetRegister (uint8_t chip, uint8_t reg_number) const { return Shadow[chip][reg_number & 0x0f]; }
+  void Flush (void);
+
+  void ShutdownStart (void)    { SetRegisterAll(REG_SHUTDOWN, 0); }
+  void ShutdownStop (void)     { SetRegisterAll(REG_SHUTDOWN, 1); }
+  void DisplayTestStart (void) { SetRegisterAll(REG_DISPLAY_TEST, 1); }
+  void DisplayTestStop (void)  { SetRegisterAll(REG_DISPLAY_TEST, 0); }
+  void SetBrightness (uint8_t chip, uint8_t brightness) {
+    SetRegister(chip, REG_INTENSITY, brightness & 0x0f);
+  }
+  void Clear (uint8_t chip);
+  void DisplayChar (uint8_t chip, char digit, char character, uint8_t setDot);
+  void DisplayString (uint8_t chip, char digit, const char *string);
+
+private:
+  enum { TRACKED = 0x9ffe };                          // digits, decode, intensity, scan, shutdown, test
+
+  uint8_t  Shadow[ChainLength][16];                   // register contents as the application wants them
+  uint16_t Dirty[ChainLength];                        // bit n: register n still to be sent
+
+  static void FrameStart (void)                            { Pins::Load::Set(); }
+  static void FrameWord (uint8_t reg_number, uint8_t data) { Transport::template Send<Pins>(reg_number);
+                                                             Transport::template Send<Pins>(data); }
+  static void FrameLatch (void);
+};
+
+
+/*
+*********************************************************************************************************
+* Max7219::Init()
+*
+* Description: Configure the pins and bring every chip of the chain to a known state: all eight digits
+*              scanned, no decode, blank, maximum intensity, not shut down, not in display test.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength, class Transport>
+void Max7219<Pins, ChainLength, Transport>::Init (void) {
+  uint8_t chip, reg;
+
+  Transport::template Init<Pins>();                   // configure "DATA" and "CLK"
+  Pins::Load::Output();                               // configure "LOAD" as output
+
+  for (chip = 0; chip < ChainLength; chip++) {
+    for (reg = 0; reg < 16; reg++)
+      Shadow[chip][reg] = 0x00;                       // blank digits, no decode, normal operation
+    Shadow[chip][REG_INTENSITY]  = INTENSITY_MAX;
+    Shadow[chip][REG_SCAN_LIMIT] = 7;
+    Shadow[chip][REG_SHUTDOWN]   = 1;
+    Dirty[chip] = TRACKED;                            // chip state is unknown: send everything
+  }
+  Flush();
+}
+
+
+/*
+*********************************************************************************************************
+* Max7219::Write()
+*
+* Description: Write a register of one chip at once, in a frame of its own (no-ops for the others).
+* Arguments  : chip = chip index
+*              reg_number = register to write
+*              dataout = value to write
+* Returns    : none
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength, class Transport>
+void Max7219<Pins, ChainLength, Transport>::Write (uint8_t chip, uint8_t reg_number, uint8_t dataout) {
+  uint8_t i;
+
+  if (chip < ChainLength) {
+    Shadow[chip][reg_number & 0x0f] = dataout;        // keep the shadow copy in step with the chip
+    Dirty[chip] &= ~(1U << (reg_number & 0x0f));
+  }
+  FrameStart();
+  for (i = ChainLength; i-- > 0; ) {                  // farthest chip first
+    if (i == chip)
+      FrameWord(reg_number, dataout);
+    else
+      FrameWord(REG_NOOP, 0);
+  }
+  FrameLatch();
+}
+
+
+/*
+*********************************************************************************************************
+* Max7219::WriteAll()
+*
+* Description: Write the same register of every chip at once, in one frame.
+* Arguments  : reg_number = register to write
+*              dataout = value to write
+* Returns    : none
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength, class Transport>
+void Max7219<Pins, ChainLength, Transport>::WriteAll (uint8_t reg_number, uint8_t dataout) {
+  uint8_t i;
+
+  FrameStart();
+  for (i = ChainLength; i-- > 0; ) {
+    Shadow[i][reg_number & 0x0f] = dataout;
+    Dirty[i] &= ~(1U << (reg_number & 0x0f));
+    FrameWord(reg_number, dataout);
+  }
+  FrameLatch();
+}
+
+
+/*
+*********************************************************************************************************
+* Max7219::SetRegister()
+*
+* Description: Update the shadow copy of a register.  Nothing is sent until Flush(); an unchanged value
+*              is not sent at all.
+* Arguments  : chip = chip index; out of range is ignored
+*              reg_number = register to update
+*              data = new register value
+* Returns    : none
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength, class Transport>
+void Max7219<Pins, ChainLength, Transport>::SetRegister (uint8_t chip, uint8_t reg_number, uint8_t data) {
+  reg_number &= 0x0f;
+  if (chip >= ChainLength || Shadow[chip][reg_number] == data)
+    return;
+  Shadow[chip][reg_number] = data;
+  Dirty[chip] |= (1U << reg_number) & TRACKED;
+}
+
+
+/*
+*********************************************************************************************************
+* Max7219::SetRegisterAll()
+*
+* Description: Update the shadow copy of a register of every chip.
+* Arguments  : reg_number = register to update
+*              data = new register value
+* Returns    : none
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength, class Transport>
+void Max7219<Pins, ChainLength, Transport>::SetRegisterAll (uint8_t reg_number, uint8_t data) {
+  uint8_t chip;
+  for (chip = 0; chip < ChainLength; chip++)
+    SetRegister(chip, reg_number, data);
+}
+
+
+/*
+*********************************************************************************************************
+* Max7219::Flush()
+*
+* Description: Send every changed register.  Each LOAD frame carries the lowest changed register of
+*              every chip (a no-op for chips with none), so a frame updates the whole chain.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength, class Transport>
+void Max7219<Pins, ChainLength, Transport>::Flush (void) {
+  uint8_t chip, reg;
+  uint16_t pending, bit;
+
+  for (;;) {
+    for (chip = 0, pending = 0; chip < ChainLength; chip++)
+      pending |= Dirty[chip];
+    if (!pending)
+      return;
+
+    FrameStart();
+    for (chip = ChainLength; chip-- > 0; ) {          // farthest chip first
+      if (Dirty[chip]) {
+        for (reg = REG_DIGIT0, bit = 1U << REG_DIGIT0; !(Dirty[chip] & bit); reg++, bit <<= 1)
+          ;
+        Dirty[chip] &= ~bit;
+        FrameWord(reg, Shadow[chip][reg]);
+      } else {
+        FrameWord(REG_NOOP, 0);
+      }
+    }
+    FrameLatch();
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* Max7219::Clear()
+*
+* Description: Clear a chip's display (all digits blank).
+* Arguments  : chip = chip index
+* Returns    : none
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength, class Transport>
+void Max7219<Pins, ChainLength, Transport>::Clear (uint8_t chip) {
+  uint8_t i;
+  for (i = REG_DIGIT0; i < REG_DIGIT0 + 8; i++)
+    SetRegister(chip, i, 0x00);                       // turn all segments off
+}
+
+
+/*
+*********************************************************************************************************
+* Max7219::DisplayChar()
+*
+* Description: Display a character on a digit of a chip.
+* Arguments  : chip = chip index
+*              digit = digit number (1-8)
+*              character = character to display (' '..'~'; anything else shows blank).  On a digit
+*                          in Code-B mode only '0'-'9', '-', E, H, L, P.
+*              setDot = nonzero to enable the digit's decimal dot
+* Returns    : none; a digit outside 1-8 is ignored
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength, class Transport>
+void Max7219<Pins, ChainLength, Transport>::DisplayChar (uint8_t chip, char digit, char character,
+                                                          uint8_t setDot) {
+  if (chip >= ChainLength || digit < 1 || digit > 8)
+    return;
+  if (Shadow[chip][REG_DECODE] & (1 << (digit - 1)))
+    SetRegister(chip, digit, MAX7219FontCodeB(character) | (setDot ? CODEB_DP : 0));  // chip decodes
+  else
+    SetRegister(chip, digit, Max7219GlyphRead(character) | (setDot ? SEG_DP : 0));
+}
+
+
+/*
+*********************************************************************************************************
+* Max7219::DisplayString()
+*
+* Description: Display a string starting at a digit.  A '.' following a character lights that digit's
+*              decimal dot instead of taking a digit of its own.
+* Arguments  : chip = chip index
+*              digit = first digit (1-8)
+*              string = characters to display; stops at the end of the string or after digit 8
+* Returns    : none
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength, class Transport>
+void Max7219<Pins, ChainLength, Transport>::DisplayString (uint8_t chip, char digit, const char *string) {
+  char character;
+  uint8_t dot;
+
+  while ((character = *string++) != '\0' && digit <= 8) {
+    dot = 0;
+    if (*string == '.' && character != '.') {         // fold the dot into this digit
+      dot = SEG_DP;
+      string++;
+    }
+    DisplayChar(chip, digit++, character, dot);
+  }
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* Max7219::FrameLatch()
+*
+* Description: End a LOAD frame: let the transport finish, then pulse LOAD to latch every chip.
+*********************************************************************************************************
+*/
+template <class Pins, uint8_t ChainLength, class Transport>
+void Max7219<Pins, ChainLength, Transport>::FrameLatch (void) {
+  Transport::Wait();                                  // let the transport finish shifting
+  Pins::Load::Clear();                                // take LOAD low to latch in data
+  Pins::Load::Set();                                  // take LOAD high to end
+}
+#endif // _MAX7219_HPP
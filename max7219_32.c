@@ -7,7 +7,8 @@
 *  allows the program to display more than the 0-9,H,E,L,P that code B provides.  However,
 *  the "no decode" method requires that each character to be displayed have a corresponding
 *  entry in a lookup table, to convert the ascii character to the proper 7-segment code.
-*  If you need to display more than the characters, simply add them to the table.
+*  The table is shared by both ports and lives in MAX7219_FONT.C.  Digits that only ever show
+*  numbers can be switched to code B with MAX7219SetDecodeMask(); they then skip the table.
 *
 *  Please see the datasheet for more details.
 *
@@ -30,13 +31,13 @@
 * Include Header Files
 *********************************************************************************************************
 */
-#include <ctype.h>
 #include "compiler.h"
 #include "preprocessor.h"
 #include "board.h"
 #include "gpio.h"
 
 #include "max7219.h"                                  // MAX7219 header file
+#include "max7219_font.h"                             // 7-segment font table
 
 
 /********************************************************************************************************
@@ -63,50 +64,89 @@
 #define LOAD_0()      gpio_clr_gpio_pin(GPIO_LOAD_PIN)
 #define LOAD_1()      gpio_set_gpio_pin(GPIO_LOAD_PIN)
 
-/*
-*********************************************************************************************************
-* LED Segments:         a
-*                     ----
-*                   f|    |b
-*                    |  g |
-*                     ----
-*                   e|    |c
-*                    |    |
-*                     ----  o dp
-*                       d
-*   Register bits:
-*      bit:  7  6  5  4  3  2  1  0
-*           dp  a  b  c  d  e  f  g
-*
-* NOTES:
-* -You can define more patterns here and use PROGMEM to store the patterns into the flash to save
-*  SRAM!
-*********************************************************************************************************
-*/
-static const struct {
-	char   ascii;
-	char   segs;
-} SegmentData[] = {
-  {' ', 0x00},
-  {'0', 0x7e},
-  {'1', 0x30},
-  {'2', 0x6d},
-  {'3', 0x79},
-  {'4', 0x33},
-  {'5', 0x5b},
-  {'6', 0x5f},
-  {'7', 0x70},
-  {'8', 0x7f},
-  {'9', 0x7b},
-  {'A', 0x77},
-  {'B', 0x1f},
-  {'C', 0x4e},
-  {'D', 0x3d},
-  {'E', 0x4f},
-  {'F', 0x47},
-  {'.', 0x80},
-  {'\0', 0x00}
-};
+/********************************************************************************************************
+* Transport
+
+  MAX7219_TRANSPORT (see MAX7219.H) selects how DATA and CLK are driven.  LOAD always stays on
+  GPIO_LOAD_PIN.
+
+  BITBANG : DATA/CLK on PA05/PA06 through gpio_set_gpio_pin()/gpio_clr_gpio_pin().
+  SPI     : the SPI module in master mode, MOSI -> pin 1 (DIN), SCK -> pin 13 (CLK).  The clock is
+            fPBA / MAX7219_SPI_SCBR (8.3 MHz at 25 MHz; the MAX7219 accepts up to 10 MHz).  The
+            transmit data register is double buffered, so both bytes of a frame go out back to back.
+  MOCK    : host build; bytes and LOAD edges go to host/max7219_mock.c.
+  LOCALBUS: the same three pins, but written straight to the OVRS/OVRC registers of the GPIO
+            local bus mapping (single cycle stores, no driver call, masks fixed at compile time).
+            A frame word is shifted as one unrolled run of 16 bits.  Needs fPBA = fCPU (see
+            main_32.c) and DATA/CLK on the same GPIO port.  Each bit is: CLK and DATA low, DATA
+            high for a 1, hold, CLK high, hold; at 25 MHz that meets the MAX7219's 25 ns data setup
+            and 50 ns CLK high/low times.  Above 40 MHz define MAX7219_LOCALBUS_HOLD() as two nops.
+
+  SPI also drives MAX7219FlushAsync(): the PDCA feeds each frame to the SPI, its transfer complete
+  interrupt arms the SPI TXEMPTY interrupt, and that one pulses LOAD.  Two interrupts per frame
+  whatever the chain length.  The application must have called INTC_init_interrupts() and enabled
+  interrupts before MAX7219Init().
+
+  Estimated cost of one MAX7219Write() at 25 MHz:
+    BITBANG  ~950 cycles (38 us) -- three GPIO driver calls per bit
+    SPI      ~110 cycles (4.4 us) -- 48 cycles on the wire, the rest is polling and LOAD
+    LOCALBUS ~110 cycles (4.4 us) -- about six cycles per bit, no call or polling
+********************************************************************************************************/
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI
+#ifndef MAX7219_SPI_SCBR
+#define MAX7219_SPI_SCBR       3                      // SPI clock = fPBA / 3
+#endif
+#ifndef MAX7219_SPI_SCK_PIN
+#define MAX7219_SPI_SCK_PIN        AVR32_SPI_SCK_0_0_PIN
+#define MAX7219_SPI_SCK_FUNCTION   AVR32_SPI_SCK_0_0_FUNCTION
+#define MAX7219_SPI_MOSI_PIN       AVR32_SPI_MOSI_0_0_PIN
+#define MAX7219_SPI_MOSI_FUNCTION  AVR32_SPI_MOSI_0_0_FUNCTION
+#endif
+#ifndef MAX7219_PDCA_CHANNEL
+#define MAX7219_PDCA_CHANNEL   0                      // PDCA channel for MAX7219FlushAsync()
+#endif
+#define TX_WAIT()     do { } while (!(AVR32_SPI.sr & AVR32_SPI_SR_TXEMPTY_MASK))
+#include "intc.h"
+#include "pdca.h"
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+#include "max7219_mock.h"
+#undef  LOAD_0
+#undef  LOAD_1
+#define LOAD_0()      MAX7219MockLoad(0)
+#define LOAD_1()      MAX7219MockLoad(1)
+#define TX_WAIT()
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_LOCALBUS
+#if (GPIO_DATA_PIN >> 5) != (GPIO_CLK_PIN >> 5)
+#error "MAX7219_TRANSPORT_LOCALBUS needs DATA and CLK on the same GPIO port"
+#endif
+#define LB_PORT        AVR32_GPIO_LOCAL.port[GPIO_DATA_PIN >> 5]
+#define LB_LOAD_PORT   AVR32_GPIO_LOCAL.port[GPIO_LOAD_PIN >> 5]
+#define LB_DATA_SHIFT  (GPIO_DATA_PIN & 0x1f)
+#define LB_DATA_MASK   (1UL << LB_DATA_SHIFT)
+#define LB_CLK_MASK    (1UL << (GPIO_CLK_PIN & 0x1f))
+#define LB_LOAD_MASK   (1UL << (GPIO_LOAD_PIN & 0x1f))
+#ifndef MAX7219_LOCALBUS_HOLD
+#define MAX7219_LOCALBUS_HOLD()  __asm__ __volatile__ ("nop")
+#endif
+// One bit, MSB first.  Writing 0 to OVRS changes nothing, so a "0" bit costs no branch.
+#define LB_BIT(word, n)                                                     \
+  do {                                                                      \
+    LB_PORT.ovrc = LB_CLK_MASK | LB_DATA_MASK;        /* CLK and DATA low */ \
+    LB_PORT.ovrs = (((uint32_t)(word) >> (n)) & 1) << LB_DATA_SHIFT;         \
+    MAX7219_LOCALBUS_HOLD();                          /* data setup */       \
+    LB_PORT.ovrs = LB_CLK_MASK;                       /* chip samples DATA */\
+    MAX7219_LOCALBUS_HOLD();                          /* CLK high time */    \
+  } while (0)
+#undef  LOAD_0
+#undef  LOAD_1
+#define LOAD_0()      (LB_LOAD_PORT.ovrc = LB_LOAD_MASK)
+#define LOAD_1()      (LB_LOAD_PORT.ovrs = LB_LOAD_MASK)
+#define TX_WAIT()
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_BITBANG
+#define TX_WAIT()
+#else
+#error "MAX7219_TRANSPORT not supported on AVR32"
+#endif
 
 /*
 *********************************************************************************************************
@@ -119,8 +159,16 @@ static const struct {
 * Private Function Prototypes
 *********************************************************************************************************
 */
+static void MAX7219TransportInit (void);
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI
+static void MAX7219PdcaIsr (void);
+static void MAX7219SpiIsr (void);
+#endif
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_LOCALBUS
+static void MAX7219SendWord (uint16_t word);
+#else
 static void MAX7219SendByte (unsigned char data);
-static unsigned char MAX7219LookupCode (char character);
+#endif
 
 // ...................................... Public Functions ..............................................
 
@@ -135,34 +183,69 @@ static unsigned char MAX7219LookupCode (char character);
 *********************************************************************************************************
 */
 void MAX7219Init (void) {
+  unsigned char i;
 
-  gpio_enable_gpio_pin(GPIO_DATA_PIN);
-  gpio_enable_gpio_pin(GPIO_CLK_PIN);
+  MAX7219TransportInit();
   gpio_enable_gpio_pin(GPIO_LOAD_PIN);
 
-  MAX7219Write(REG_SCAN_LIMIT, 7);                   // set up to scan all eight digits
-  MAX7219Write(REG_DECODE, 0x00);                    // set to "no decode" for all digits
-  MAX7219ShutdownStop();                             // select normal operation (i.e. not shutdown)
-  MAX7219DisplayTestStop();                          // select normal operation (i.e. not test mode)
-  MAX7219Clear();                                    // clear all digits
-  MAX7219SetBrightness(INTENSITY_MAX);               // set to maximum intensity
+  MAX7219Invalidate();                               // chip state is unknown: send everything
+  MAX7219SetRegisterAll(REG_SCAN_LIMIT, 7);          // set up to scan all eight digits
+  MAX7219SetRegisterAll(REG_DECODE, 0x00);           // set to "no decode" for all digits
+  MAX7219SetRegisterAll(REG_SHUTDOWN, 1);            // select normal operation (i.e. not shutdown)
+  MAX7219SetRegisterAll(REG_DISPLAY_TEST, 0);        // select normal operation (i.e. not test mode)
+  for (i = REG_DIGIT0; i < REG_DIGIT0 + 8; i++)
+    MAX7219SetRegisterAll(i, 0x00);                  // clear all digits
+  MAX7219SetRegisterAll(REG_INTENSITY, INTENSITY_MAX); // set to maximum intensity
+  MAX7219Flush();                                    // one frame per register for the whole chain
 }
 
 
 /*
 *********************************************************************************************************
-* MAX7219Write()
+* MAX7219FrameStart()
 *
-* Description: Write to MAX7219
-* Arguments  : reg_number = register to write to, basically the digit id, 0-7.
-*              dataout = data to write to MAX7219
+* Description: Begin a LOAD frame.  Follow with one MAX7219FrameWord() per chip in the chain, farthest
+*              chip first, then MAX7219FrameLatch().
+* Arguments  : none
 * Returns    : none
 *********************************************************************************************************
 */
-void MAX7219Write (unsigned char reg_number, unsigned char dataout) {
+void MAX7219FrameStart (void) {
   LOAD_1();                                           // take LOAD high to begin
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FrameWord()
+*
+* Description: Shift one register/data pair into the chain.
+* Arguments  : reg_number = register to write to (REG_NOOP for chips that are not addressed)
+*              dataout = data to write to MAX7219
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219FrameWord (unsigned char reg_number, unsigned char dataout) {
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_LOCALBUS
+  MAX7219SendWord(((uint16_t)reg_number << 8) | dataout);  // register number and data in one run
+#else
   MAX7219SendByte(reg_number);                        // write register number to MAX7219
   MAX7219SendByte(dataout);                           // write data to MAX7219
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FrameLatch()
+*
+* Description: End a LOAD frame; every chip latches the word in its shift register.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219FrameLatch (void) {
+  TX_WAIT();                                          // let the transport finish shifting
   LOAD_0();                                           // take LOAD low to latch in data
   LOAD_1();                                           // take LOAD high to end
 }
@@ -178,7 +261,7 @@ void MAX7219Write (unsigned char reg_number, unsigned char dataout) {
 *********************************************************************************************************
 */
 void MAX7219ShutdownStart (void) {
-  MAX7219Write(REG_SHUTDOWN, 0);                     // put MAX7219 into "shutdown" mode
+  MAX7219SetRegister(REG_SHUTDOWN, 0);               // put MAX7219 into "shutdown" mode
 }
 
 
@@ -192,7 +275,7 @@ void MAX7219ShutdownStart (void) {
 *********************************************************************************************************
 */
 void MAX7219ShutdownStop (void) {
-  MAX7219Write(REG_SHUTDOWN, 1);                     // put MAX7219 into "normal" mode
+  MAX7219SetRegister(REG_SHUTDOWN, 1);               // put MAX7219 into "normal" mode
 }
 
 
@@ -206,7 +289,7 @@ void MAX7219ShutdownStop (void) {
 *********************************************************************************************************
 */
 void MAX7219DisplayTestStart (void) {
-  MAX7219Write(REG_DISPLAY_TEST, 1);                 // put MAX7219 into "display test" mode
+  MAX7219SetRegister(REG_DISPLAY_TEST, 1);           // put MAX7219 into "display test" mode
 }
 
 
@@ -220,7 +303,7 @@ void MAX7219DisplayTestStart (void) {
 *********************************************************************************************************
 */
 void MAX7219DisplayTestStop (void) {
-  MAX7219Write(REG_DISPLAY_TEST, 0);                 // put MAX7219 into "normal" mode
+  MAX7219SetRegister(REG_DISPLAY_TEST, 0);           // put MAX7219 into "normal" mode
 }
 
 
@@ -235,7 +318,7 @@ void MAX7219DisplayTestStop (void) {
 */
 void MAX7219SetBrightness (char brightness) {
   brightness &= 0x0f;                                // mask off extra bits
-  MAX7219Write(REG_INTENSITY, brightness);           // set brightness
+  MAX7219SetRegister(REG_INTENSITY, brightness);     // set brightness
 }
 
 
@@ -249,9 +332,9 @@ void MAX7219SetBrightness (char brightness) {
 *********************************************************************************************************
 */
 void MAX7219Clear (void) {
-  char i;
-  for (i=0; i < 8; i++)
-    MAX7219Write(i, 0x00);                           // turn all segments off
+  unsigned char i;
+  for (i = REG_DIGIT0; i < REG_DIGIT0 + 8; i++)
+    MAX7219SetRegister(i, 0x00);                     // turn all segments off
 }
 
 
@@ -261,15 +344,19 @@ void MAX7219Clear (void) {
 *
 * Description: Display a character on the specified digit.
 * Arguments  : digit = digit number (1-8)
-*              character = character to display (0-9, A-Z, etc.)
-*              setDot = 0x80 to enable the digit's decimal dot. 0x00 not to enable.
-* Returns    : none
+*              character = character to display (' '..'~'; anything else shows blank).  On a digit
+*                          in Code-B mode (see MAX7219SetDecodeMask()) only '0'-'9', '-', E, H, L, P.
+*              setDot = nonzero (e.g. SEG_DP) to enable the digit's decimal dot. 0x00 not to enable.
+* Returns    : none; a digit outside 1-8 is ignored
 *********************************************************************************************************
 */
 void MAX7219DisplayChar (char digit, char character, unsigned char setDot) {
-  character = toupper(character);
-  unsigned char byte = MAX7219LookupCode(character);
-  MAX7219Write(digit, byte | setDot);
+  if (digit < 1 || digit > 8)
+    return;
+  if (MAX7219GetRegister(REG_DECODE) & (1 << (digit - 1)))
+    MAX7219SetRegister(digit, MAX7219FontCodeB(character) | (setDot ? CODEB_DP : 0));  // chip decodes
+  else
+    MAX7219SetRegister(digit, MAX7219FontGlyph(character) | (setDot ? SEG_DP : 0));
 }
 
 /*
@@ -278,35 +365,129 @@ void MAX7219DisplayChar (char digit, char character, unsigned char setDot) {
 *
 * Description: Display the colon and/or degree dots
 * Arguments  : bit = L1/L2/L3 constants can be OR'ed together to display any of the dots of the colon
-*              or the degree dot.
+*              or the degree dot.  They are wired to segments C, B and A of digit 3.
 * Returns    : none
 *********************************************************************************************************
 */
 void MAX7219DisplayL123(char bits) {
-  MAX7219Write(3, bits << 4);
+  MAX7219SetRegister(3, ((bits & L1) ? SEG_C : 0) |  // through SEG_x, so a board wiring applies
+                        ((bits & L2) ? SEG_B : 0) |
+                        ((bits & L3) ? SEG_A : 0));
 }	
 
+#if MAX7219_TRANSPORT_IRQ
+/*
+*********************************************************************************************************
+* MAX7219FrameSendAsync()
+*
+* Description: Start sending a frame in the background.  The PDCA feeds the SPI; the interrupt
+*              handlers pulse LOAD and call MAX7219AsyncFrameDone().
+* Arguments  : frame = bytes to send, farthest chip first; must stay valid until the frame is latched
+*              len = number of bytes (two per chip)
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219FrameSendAsync (const unsigned char *frame, unsigned char len) {
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+  MAX7219MockSendAsync(frame, len);                   // host/max7219_mock.c plays the interrupt
+#else
+  LOAD_1();                                           // take LOAD high to begin
+  pdca_load_channel(MAX7219_PDCA_CHANNEL, (void *)frame, len);
+  pdca_enable_interrupt_transfer_complete(MAX7219_PDCA_CHANNEL);
+  pdca_enable(MAX7219_PDCA_CHANNEL);
+#endif
+}
+#endif
+
 // ..................................... Private Functions ..............................................
 
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI
 /*
 *********************************************************************************************************
-* MAX7219LookupCode()
+* MAX7219PdcaIsr()
 *
-* Description: Convert an alphanumeric character to the corresponding 7-segment code.
-* Arguments  : character to display
-* Returns    : segment code
+* Description: The PDCA has handed the last byte to the SPI; wait for it to leave the shifter.
 *********************************************************************************************************
 */
-static unsigned char MAX7219LookupCode (char character) {
-  character = toupper(character);
-  unsigned char i;
-  for (i = 0; SegmentData[i].ascii; i++)      // scan font table for ascii code
-    if (character == SegmentData[i].ascii)
-      return SegmentData[i].segs;                     // return segments code
-  return 0;                                           // code not found, return null (blank)
+__attribute__((__interrupt__))
+static void MAX7219PdcaIsr (void) {
+  pdca_disable_interrupt_transfer_complete(MAX7219_PDCA_CHANNEL);
+  AVR32_SPI.ier = AVR32_SPI_IER_TXEMPTY_MASK;
 }
 
-/*********************************************************************************************************
+
+/*
+*********************************************************************************************************
+* MAX7219SpiIsr()
+*
+* Description: The frame is completely shifted out; latch it and move on to the next one.
+*********************************************************************************************************
+*/
+__attribute__((__interrupt__))
+static void MAX7219SpiIsr (void) {
+  AVR32_SPI.idr = AVR32_SPI_IDR_TXEMPTY_MASK;
+  LOAD_0();                                           // take LOAD low to latch in data
+  LOAD_1();                                           // take LOAD high to end
+  MAX7219AsyncFrameDone();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+* MAX7219TransportInit()
+*
+* Description: Set up the pins or the peripheral that shift frames out to the MAX7219.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+static void MAX7219TransportInit (void) {
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI
+  static const gpio_map_t spi_map = {
+    {MAX7219_SPI_SCK_PIN,  MAX7219_SPI_SCK_FUNCTION},
+    {MAX7219_SPI_MOSI_PIN, MAX7219_SPI_MOSI_FUNCTION}
+  };
+  gpio_enable_module(spi_map, sizeof(spi_map) / sizeof(spi_map[0]));
+
+  AVR32_SPI.cr   = AVR32_SPI_CR_SWRST_MASK;           // start from a clean state
+  AVR32_SPI.mr   = AVR32_SPI_MR_MSTR_MASK |           // master, no mode fault detection, NPCS0
+                   AVR32_SPI_MR_MODFDIS_MASK |
+                   (0x0e << AVR32_SPI_MR_PCS_OFFSET);
+  AVR32_SPI.csr0 = (MAX7219_SPI_SCBR << AVR32_SPI_CSR0_SCBR_OFFSET) |
+                   (0 << AVR32_SPI_CSR0_BITS_OFFSET) | // 8 bits per transfer
+                   AVR32_SPI_CSR0_NCPHA_MASK;         // mode 0: sample on the rising edge
+  AVR32_SPI.cr   = AVR32_SPI_CR_SPIEN_MASK;
+
+  static const pdca_channel_options_t pdca_options = {
+    .addr          = NULL,
+    .size          = 0,
+    .r_addr        = NULL,
+    .r_size        = 0,
+    .pid           = AVR32_PDCA_PID_SPI_TX,           // PDCA writes SPI TDR
+    .transfer_size = PDCA_TRANSFER_SIZE_BYTE
+  };
+  pdca_init_channel(MAX7219_PDCA_CHANNEL, &pdca_options);
+  INTC_register_interrupt(&MAX7219PdcaIsr, AVR32_PDCA_IRQ_0 + MAX7219_PDCA_CHANNEL, AVR32_INTC_INT0);
+  INTC_register_interrupt(&MAX7219SpiIsr, AVR32_SPI_IRQ, AVR32_INTC_INT0);
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+                                                      // nothing to set up on the host
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_LOCALBUS
+  gpio_local_init();                                  // map the GPIO onto the CPU local bus
+  gpio_enable_gpio_pin(GPIO_DATA_PIN);
+  gpio_enable_gpio_pin(GPIO_CLK_PIN);
+  gpio_local_enable_pin_output_driver(GPIO_DATA_PIN); // the PBA output enable does not apply
+  gpio_local_enable_pin_output_driver(GPIO_CLK_PIN);  // to local bus accesses
+  gpio_local_enable_pin_output_driver(GPIO_LOAD_PIN);
+#else
+  gpio_enable_gpio_pin(GPIO_DATA_PIN);
+  gpio_enable_gpio_pin(GPIO_CLK_PIN);
+#endif
+}
+
+
+/*
+*********************************************************************************************************
 * MAX7219SendByte()
 *
 * Description: Send one byte to the MAX7219
@@ -314,6 +495,33 @@ static unsigned char MAX7219LookupCode (char character) {
 * Returns    : none
 *********************************************************************************************************
 */
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_SPI
+static void MAX7219SendByte (unsigned char dataout) {
+  while (!(AVR32_SPI.sr & AVR32_SPI_SR_TDRE_MASK))    // wait for room in the transmit register
+    ;
+  AVR32_SPI.tdr = dataout;
+}
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_MOCK
+static void MAX7219SendByte (unsigned char dataout) {
+  MAX7219MockSendByte(dataout);
+}
+#elif MAX7219_TRANSPORT == MAX7219_TRANSPORT_LOCALBUS
+/*
+*********************************************************************************************************
+* MAX7219SendWord()
+*
+* Description: Send one 16-bit register/data word to the MAX7219 over the local bus, MSB first.
+* Arguments  : word = register number in the high byte, data in the low byte
+* Returns    : none
+*********************************************************************************************************
+*/
+static void MAX7219SendWord (uint16_t word) {
+  LB_BIT(word, 15); LB_BIT(word, 14); LB_BIT(word, 13); LB_BIT(word, 12);
+  LB_BIT(word, 11); LB_BIT(word, 10); LB_BIT(word,  9); LB_BIT(word,  8);
+  LB_BIT(word,  7); LB_BIT(word,  6); LB_BIT(word,  5); LB_BIT(word,  4);
+  LB_BIT(word,  3); LB_BIT(word,  2); LB_BIT(word,  1); LB_BIT(word,  0);
+}
+#else
 static void MAX7219SendByte (unsigned char dataout) {
   char i;
   for (i = 8; i > 0; i--) {
@@ -326,3 +534,4 @@ static void MAX7219SendByte (unsigned char dataout) {
     CLK_1();                                          // bring CLK high
   }
 }
+#endif
@@ -0,0 +1,238 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_AMBIENT.C
+* Description: MAX7219 intensity following the ambient light (optional)
+*
+*  A light sensor (e.g. an LDR divider or a phototransistor: brighter = higher voltage) on an ADC
+*  input sets the intensity.  Every MAX7219AmbientTick() reads the conversion started by the previous
+*  tick and starts the next one, so it never waits for the ADC, and costs the same few dozen cycles
+*  every time:
+*
+*    - a first-order IIR filter in fixed point, level += sample - level / 2^MAX7219_AMBIENT_SHIFT,
+*      smooths flicker from mains lighting and sensor noise;
+*    - the filtered reading maps linearly onto the intensity range given to MAX7219AmbientInit();
+*    - the intensity only moves once the reading is MAX7219_AMBIENT_HYST counts past the edge of the
+*      current step, so a reading sitting on an edge does not make the display flicker between two
+*      steps;
+*    - the intensity registers of the chain are written only when the step changes.
+*
+*  Call MAX7219AmbientTick() from a scheduler task (MAX7219SchedAdd(MAX7219AmbientTick, 5) samples
+*  ten times a second at 50 Hz).  The filter's time constant is 2^MAX7219_AMBIENT_SHIFT ticks.  Do
+*  not combine it with the fades of MAX7219_FADE.C.
+*
+*  ADC per port:
+*    ATmega  ADC channel MAX7219_AMBIENT_CHANNEL (default ADC3/PC3, next to the MAX7219 pins), AVcc
+*            reference, clk / 128.  On the host the ADC registers are plain variables: a host program
+*            writes ADCW to stand in for the sensor.
+*    UC3L    ADCIFB channel MAX7219_AMBIENT_CHANNEL (default AD0), 10 bits.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+
+#if defined(__AVR32__)
+#include "compiler.h"
+#include "gpio.h"
+#include "adcifb.h"
+#else
+#include <avr/io.h>                                   // ADC registers (host: stand-ins)
+#endif
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define AMBIENT_MAX       1023                        // 10-bit readings, hence the >> 10 below
+
+#if MAX7219_AMBIENT_SHIFT > 6
+#error "MAX7219_AMBIENT_SHIFT must be at most 6, the filter state is 16 bits"
+#endif
+
+#if defined(__AVR32__)
+#ifndef MAX7219_AMBIENT_CHANNEL
+#define MAX7219_AMBIENT_CHANNEL   0
+#define MAX7219_AMBIENT_PIN       AVR32_ADCIFB_AD_0_PIN
+#define MAX7219_AMBIENT_FUNCTION  AVR32_ADCIFB_AD_0_FUNCTION
+#endif
+#ifndef MAX7219_AMBIENT_PBA_HZ
+#define MAX7219_AMBIENT_PBA_HZ    25000000UL          // main_32.c runs fPBA at 25 MHz
+#endif
+#define AMBIENT_ADC_HZ    1500000UL                   // ADC clock
+#else
+#ifndef MAX7219_AMBIENT_CHANNEL
+#define MAX7219_AMBIENT_CHANNEL   3                   // ADC3 = PC3; PC0-PC2 drive the MAX7219
+#endif
+#endif
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static uint16_t      MAX7219AmbientFilter;            // level * 2^MAX7219_AMBIENT_SHIFT
+static unsigned char MAX7219AmbientPrimed;            // the filter holds a reading
+static unsigned char MAX7219AmbientMin;               // intensity in the dark
+static unsigned char MAX7219AmbientMax;               // intensity in full light
+static unsigned char MAX7219AmbientStep;              // intensity last written
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static int MAX7219AmbientSample (void);
+static unsigned char MAX7219AmbientIntensity (int reading);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219AmbientInit()
+*
+* Description: Set up the ADC and start the first conversion.  The first tick sets the intensity
+*              from that reading without filtering.
+* Arguments  : min_intensity = intensity in the dark (0-15)
+*              max_intensity = intensity in full light (min_intensity-15)
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219AmbientInit (unsigned char min_intensity, unsigned char max_intensity) {
+  MAX7219AmbientMin = min_intensity & 0x0f;
+  MAX7219AmbientMax = max_intensity & 0x0f;
+  if (MAX7219AmbientMax < MAX7219AmbientMin)
+    MAX7219AmbientMax = MAX7219AmbientMin;
+  MAX7219AmbientPrimed = 0;
+
+#if defined(__AVR32__)
+  static const adcifb_opt_t options = {
+    .resolution             = AVR32_ADCIFB_ACR_RES_10BIT,
+    .shtim                  = 15,                     // sample and hold time, in ADC clocks
+    .ratio_clkadcifb_clkadc = MAX7219_AMBIENT_PBA_HZ / AMBIENT_ADC_HZ,
+    .startup                = 3,
+    .sleep_mode_enable      = false
+  };
+  gpio_enable_module_pin(MAX7219_AMBIENT_PIN, MAX7219_AMBIENT_FUNCTION);
+  adcifb_configure(&AVR32_ADCIFB, &options);
+  adcifb_configure_trigger(&AVR32_ADCIFB, AVR32_ADCIFB_TRGMOD_NT, 0);  // started by software
+  adcifb_channels_enable(&AVR32_ADCIFB, 1 << MAX7219_AMBIENT_CHANNEL);
+  adcifb_start_conversion_sequence(&AVR32_ADCIFB);
+#else
+  ADMUX  = _BV(REFS0) | MAX7219_AMBIENT_CHANNEL;      // AVcc reference, right adjusted
+#ifdef DIDR0                                          // not on the ATmega8/16/32
+  DIDR0  = _BV(MAX7219_AMBIENT_CHANNEL);              // no digital input buffer on the sensor pin
+#endif
+  ADCSRA = _BV(ADEN) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);  // clk / 128
+  ADCSRA |= _BV(ADSC);
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219AmbientTick()
+*
+* Description: Take the last reading, filter it, follow it with the intensity of every chip in the
+*              chain, and start the next conversion.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219AmbientTick (void) {
+  int sample = MAX7219AmbientSample();
+  unsigned char step;
+
+  if (sample < 0)                                     // conversion not finished (UC3L only)
+    return;
+  if (!MAX7219AmbientPrimed) {
+    MAX7219AmbientPrimed = 1;
+    MAX7219AmbientFilter = (uint16_t)sample << MAX7219_AMBIENT_SHIFT;
+    MAX7219AmbientStep = MAX7219AmbientIntensity(sample);
+    MAX7219SetRegisterAll(REG_INTENSITY, MAX7219AmbientStep);
+    return;
+  }
+  MAX7219AmbientFilter += sample - (MAX7219AmbientFilter >> MAX7219_AMBIENT_SHIFT);
+  sample = MAX7219AmbientFilter >> MAX7219_AMBIENT_SHIFT;
+
+  step = MAX7219AmbientIntensity(sample - MAX7219_AMBIENT_HYST);  // brighter only if clearly so
+  if (step <= MAX7219AmbientStep) {
+    step = MAX7219AmbientIntensity(sample + MAX7219_AMBIENT_HYST);
+    if (step >= MAX7219AmbientStep)                   // inside the band around the current step
+      return;
+  }
+  MAX7219AmbientStep = step;
+  MAX7219SetRegisterAll(REG_INTENSITY, step);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219AmbientLevel()
+*
+* Description: Read the filtered light level.
+* Arguments  : none
+* Returns    : 0 (dark) to 1023 (full scale)
+*********************************************************************************************************
+*/
+uint16_t MAX7219AmbientLevel (void) {
+  return MAX7219AmbientFilter >> MAX7219_AMBIENT_SHIFT;
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219AmbientSample()
+*
+* Description: Take the result of the running conversion and start the next one.  Returns -1 if the
+*              conversion has not finished yet.
+*********************************************************************************************************
+*/
+static int MAX7219AmbientSample (void) {
+  int sample;
+
+#if defined(__AVR32__)
+  if (!adcifb_is_drdy(&AVR32_ADCIFB))
+    return -1;
+  sample = adcifb_get_last_data(&AVR32_ADCIFB) & AVR32_ADCIFB_LCDR_LDATA_MASK;
+  adcifb_start_conversion_sequence(&AVR32_ADCIFB);
+#else
+  sample = ADCW;                                      // 13 ADC clocks (104 us) ago: long done
+  ADCSRA |= _BV(ADSC);
+#endif
+  return sample;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219AmbientIntensity()
+*
+* Description: Map a reading (clamped to 0-1023) linearly onto the intensity range.
+*********************************************************************************************************
+*/
+static unsigned char MAX7219AmbientIntensity (int reading) {
+  if (reading < 0)
+    reading = 0;
+  if (reading > AMBIENT_MAX)
+    reading = AMBIENT_MAX;
+  return MAX7219AmbientMin +
+         (unsigned char)(((uint32_t)reading * (MAX7219AmbientMax - MAX7219AmbientMin + 1)) >> 10);
+}
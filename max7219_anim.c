@@ -0,0 +1,172 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_ANIM.C
+* Description: MAX7219 delta-encoded animation player (port independent)
+*
+*  An animation is a byte string in flash (PROGMEM on the ATmega), made by host/max7219_animenc.c from
+*  a list of frames.  It is a sequence of records, one per displayed frame, for digits 1-8 of chip 0:
+*
+*    1hhhhhhh d1 d2 ... d8       keyframe: all eight digits
+*    0hhhhhhh mask dn ...        delta: bit n of mask set = digit n + 1 changed, its new value follows
+*    11111111                    end of the animation
+*
+*  hhhhhhh is how many ticks the frame is shown (1-126); a frame held longer, or any run of identical
+*  frames, continues in delta records with an empty mask.  A keyframe costs 9 bytes, a delta 2 bytes
+*  plus one per changed digit, against 8 bytes for a stored full frame.
+*
+*  The player keeps only a pointer into the string and a tick count: each record is read straight
+*  from flash into the shadow registers, and nothing is decoded into RAM.  The flush then sends only
+*  the digits that really changed, so a keyframe costs no more bus time than a delta.
+*  MAX7219AnimTick() advances the animation and leaves the flush to its caller; run it as a scheduler
+*  task (MAX7219SchedAdd(MAX7219AnimTick, 1)), which flushes after every pass.  Digits must be in
+*  no-decode mode.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+#include "max7219_font.h"                             // FONT_READ()
+
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static const uint8_t *MAX7219AnimFirst;               // first record, in flash
+static const uint8_t *MAX7219AnimNext;                // next record to play
+static unsigned char MAX7219AnimHold;                 // ticks until the next record
+static unsigned char MAX7219AnimRepeat;               // start over at the end
+static volatile unsigned char MAX7219AnimActive;      // an animation is playing
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void MAX7219AnimPlay (void);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219AnimStart()
+*
+* Description: Show the first frame of an animation and start playing it.  An animation without
+*              frames (only the end marker) is not started.
+* Arguments  : anim = animation in flash (declared MAX7219_ANIM_ATTR), starting with a keyframe
+*              repeat = 1 to loop, 0 to stop on the last frame
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219AnimStart (const uint8_t *anim, unsigned char repeat) {
+  MAX7219AnimActive = 0;
+  MAX7219AnimFirst  = anim;
+  MAX7219AnimNext   = anim;
+  MAX7219AnimRepeat = repeat;
+  MAX7219AnimActive = 1;
+  MAX7219AnimPlay();
+  MAX7219FlushAsync(0);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219AnimStop()
+*
+* Description: Stop playing; the display keeps the current frame.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219AnimStop (void) {
+  MAX7219AnimActive = 0;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219AnimRunning()
+*
+* Description: Poll the animation.
+* Arguments  : none
+* Returns    : 1 while playing, 0 after the last frame of a non-repeating animation or after
+*              MAX7219AnimStop()
+*********************************************************************************************************
+*/
+unsigned char MAX7219AnimRunning (void) {
+  return MAX7219AnimActive;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219AnimTick()
+*
+* Description: Advance the animation by one tick; when the current frame has been shown long enough,
+*              put the next one into the shadow registers for the next flush.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219AnimTick (void) {
+  if (!MAX7219AnimActive)
+    return;
+  if (--MAX7219AnimHold == 0)
+    MAX7219AnimPlay();
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219AnimPlay()
+*
+* Description: Put the next record into the shadow registers and load its hold time.  At the end
+*              marker, start over or stop; an animation that has no frames stops at once.
+*********************************************************************************************************
+*/
+static void MAX7219AnimPlay (void) {
+  const uint8_t *next = MAX7219AnimNext;
+  uint8_t head = FONT_READ(next++);
+  uint8_t mask;
+  unsigned char digit;
+
+  if (head == MAX7219_ANIM_END) {
+    if (!MAX7219AnimRepeat) {
+      MAX7219AnimActive = 0;
+      return;
+    }
+    next = MAX7219AnimFirst;
+    head = FONT_READ(next++);
+  }
+  if (head == MAX7219_ANIM_END) {                     // nothing to play
+    MAX7219AnimActive = 0;
+    return;
+  }
+
+  mask = (head & MAX7219_ANIM_KEY) ? 0xff : FONT_READ(next++);
+  for (digit = 0; digit < 8; digit++, mask >>= 1)
+    if (mask & 1)
+      MAX7219SetRegister(REG_DIGIT0 + digit, FONT_READ(next++));
+
+  MAX7219AnimHold = head & MAX7219_ANIM_HOLD;
+  if (MAX7219AnimHold == 0)
+    MAX7219AnimHold = 1;
+  MAX7219AnimNext = next;
+}
@@ -0,0 +1,218 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_BUFFER.C
+* Description: MAX7219 double-buffered frames (port independent)
+*
+*  Redrawing a whole frame straight into the shadow registers lets a flush that is already running
+*  (or one started by an interrupt) send half of the new frame next to half of the old one.  Here the
+*  application draws into a back buffer instead, at its own pace and without touching the bus.
+*  MAX7219BufferCommit() swaps the back and front buffers and hands only the digits that differ from
+*  the previous front to the shadow registers, then starts one flush: the display changes in a
+*  single burst.
+*
+*  MAX7219BufferCommitOnTick() leaves the swap to the next MAX7219BufferTick(), run as a scheduler
+*  task, so frames change at a fixed rate.  Until MAX7219BufferPending() returns 0 the back buffer
+*  belongs to the tick: do not draw.
+*
+*  No swap happens while an asynchronous flush is still sending, or its remaining frames would carry
+*  the new digits next to the rest of the old frame.  MAX7219BufferCommit() waits for the flush to
+*  end; MAX7219BufferTick() leaves the swap to a later tick.
+*
+*  The buffers cover the digit registers 1-8 (the rows of a matrix) of every chip in the chain, 16
+*  bytes of RAM per chip.  After a swap the new back buffer holds the frame just committed, so the
+*  next frame can be drawn as changes to it.  While the buffers are used, the application should
+*  write the digit registers through them only.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define BUFFER_DIGITS     8                           // digit registers 1-8
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static uint8_t MAX7219Buffer[2][MAX7219_CHAIN_MAX][BUFFER_DIGITS];  // front and back frame
+static volatile unsigned char MAX7219BufferBack;      // index of the buffer being drawn
+static volatile unsigned char MAX7219BufferSwapTick;  // swap requested for the next tick
+static unsigned char MAX7219BufferSynced;             // the old front matches the shadow registers
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void MAX7219BufferSwap (void);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219BufferSet()
+*
+* Description: Draw one digit (matrix row) of the back buffer.
+* Arguments  : chip = chip index (0 = nearest the MCU)
+*              digit = digit register (1-8)
+*              data = segment bits (bit 7 = dot)
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219BufferSet (unsigned char chip, char digit, uint8_t data) {
+  if (chip >= MAX7219_CHAIN_MAX || digit < 1 || digit > BUFFER_DIGITS)
+    return;
+  MAX7219Buffer[MAX7219BufferBack][chip][digit - 1] = data;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219BufferGet()
+*
+* Description: Read back one digit (matrix row) of the back buffer.
+* Arguments  : chip = chip index (0 = nearest the MCU)
+*              digit = digit register (1-8)
+* Returns    : segment bits, 0 for an invalid chip or digit
+*********************************************************************************************************
+*/
+uint8_t MAX7219BufferGet (unsigned char chip, char digit) {
+  if (chip >= MAX7219_CHAIN_MAX || digit < 1 || digit > BUFFER_DIGITS)
+    return 0;
+  return MAX7219Buffer[MAX7219BufferBack][chip][digit - 1];
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219BufferClear()
+*
+* Description: Blank every digit of the back buffer.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219BufferClear (void) {
+  unsigned char chip, digit;
+  for (chip = 0; chip < MAX7219_CHAIN_MAX; chip++)
+    for (digit = 0; digit < BUFFER_DIGITS; digit++)
+      MAX7219Buffer[MAX7219BufferBack][chip][digit] = 0;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219BufferCommit()
+*
+* Description: Show the back buffer now: wait for a running asynchronous flush to end, swap the
+*              buffers and start sending the changed digits with MAX7219FlushAsync().
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219BufferCommit (void) {
+  MAX7219BufferSwapTick = 0;
+  while (MAX7219FlushBusy())                          // the previous frame goes out whole
+    ;
+  MAX7219BufferSwap();
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219BufferCommitOnTick()
+*
+* Description: Show the back buffer at the next MAX7219BufferTick().  Returns at once; do not draw
+*              until MAX7219BufferPending() returns 0.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219BufferCommitOnTick (void) {
+  MAX7219BufferSwapTick = 1;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219BufferPending()
+*
+* Description: Poll a MAX7219BufferCommitOnTick() request.
+* Arguments  : none
+* Returns    : 1 while the swap has not happened yet, 0 once the back buffer can be drawn again
+*********************************************************************************************************
+*/
+unsigned char MAX7219BufferPending (void) {
+  return MAX7219BufferSwapTick;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219BufferTick()
+*
+* Description: Carry out a MAX7219BufferCommitOnTick() request; run as a scheduler task.  While an
+*              asynchronous flush is running the request stays pending for the next tick.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219BufferTick (void) {
+  if (!MAX7219BufferSwapTick || MAX7219FlushBusy())
+    return;
+  MAX7219BufferSwap();
+  MAX7219BufferSwapTick = 0;                          // the back buffer is the application's again
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219BufferSwap()
+*
+* Description: Make the back buffer the front one and pass the digits that differ from the old front
+*              to the shadow registers.  The old front becomes the back buffer and is brought up to
+*              date on the way, so the application continues from the frame just shown.  The first
+*              swap passes every digit, whatever the chips showed before.
+*********************************************************************************************************
+*/
+static void MAX7219BufferSwap (void) {
+  unsigned char front = MAX7219BufferBack;
+  unsigned char back = front ^ 1;
+  unsigned char chip, digit;
+  uint8_t data;
+
+  MAX7219BufferBack = back;                           // one byte store: drawing moves over at once
+  for (chip = 0; chip < MAX7219GetChainLength(); chip++)
+    for (digit = 0; digit < BUFFER_DIGITS; digit++) {
+      data = MAX7219Buffer[front][chip][digit];
+      if (MAX7219BufferSynced && data == MAX7219Buffer[back][chip][digit])
+        continue;
+      MAX7219Buffer[back][chip][digit] = data;
+      MAX7219SetRegisterChip(chip, REG_DIGIT0 + digit, data);
+    }
+  MAX7219BufferSynced = 1;
+  MAX7219FlushAsync(0);                               // the changed digits, in one burst
+}
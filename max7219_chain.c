@@ -0,0 +1,161 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_CHAIN.C
+* Description: MAX7219 daisy chain register writes (port independent)
+*
+*  MAX7219s can be cascaded by wiring DOUT of one chip to DIN of the next; all chips share CLK and
+*  LOAD.  A frame shifts one 16-bit word per chip, farthest chip first, and a single LOAD pulse then
+*  latches every word at once.  Chips that should keep their state are sent a no-op (register 0x00).
+*
+*  The frame itself is clocked out by the port (MAX7219FrameStart/Word/Latch in MAX7219.C or
+*  MAX7219_32.C).
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static unsigned char MAX7219ChainLength = MAX7219_CHAIN_MAX;  // chips actually wired up
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219SetChainLength()
+*
+* Description: Set the number of chips in the chain.  Call before MAX7219Init().
+* Arguments  : length = number of chips, 1..MAX7219_CHAIN_MAX.  With MAX7219_TRANSPORT_PARALLEL it is
+*              rounded up to a multiple of MAX7219_PARALLEL_LINES, since every chain shifts the same
+*              number of bytes.
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SetChainLength (unsigned char length) {
+  if (length < 1)
+    length = 1;
+#if MAX7219_TRANSPORT == MAX7219_TRANSPORT_PARALLEL
+  length = (length + MAX7219_PARALLEL_LINES - 1) / MAX7219_PARALLEL_LINES * MAX7219_PARALLEL_LINES;
+#endif
+  if (length > MAX7219_CHAIN_MAX)
+    length = MAX7219_CHAIN_MAX;
+  MAX7219ChainLength = length;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219GetChainLength()
+*
+* Description: Return the number of chips in the chain.
+* Arguments  : none
+* Returns    : chain length
+*********************************************************************************************************
+*/
+unsigned char MAX7219GetChainLength (void) {
+  return MAX7219ChainLength;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219Write()
+*
+* Description: Write to MAX7219 (chip 0) immediately, bypassing the dirty-register tracking.
+* Arguments  : reg_number = register to write to, basically the digit id, 1-8.
+*              dataout = data to write to MAX7219
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219Write (unsigned char reg_number, unsigned char dataout) {
+  MAX7219WriteChip(0, reg_number, dataout);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219WriteChip()
+*
+* Description: Write one register of one chip in a single LOAD frame.  All other chips get a no-op.
+*              Inside MAX7219Begin()/MAX7219Commit() the write is queued in the shadow copy instead.
+* Arguments  : chip = chip index (0 = nearest the MCU)
+*              reg_number = register to write to
+*              dataout = data to write
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219WriteChip (unsigned char chip, unsigned char reg_number, unsigned char dataout) {
+  unsigned char i;
+
+  if (MAX7219InTransaction() && MAX7219ShadowDeferrable(reg_number)) {
+    MAX7219SetRegisterChip(chip, reg_number, dataout);  // goes out with MAX7219Commit()
+    return;
+  }
+  MAX7219_STATS_START();
+  while (MAX7219FlushBusy())                          // don't cut into an asynchronous flush
+    ;
+  MAX7219ShadowUpdate(chip, reg_number, dataout);     // keep the shadow copy in step with the chip
+  MAX7219_STATS_WORD(chip, reg_number, dataout);
+  MAX7219FrameStart();
+  for (i = MAX7219ChainLength; i-- > 0; ) {           // farthest chip first
+    if (i == chip)
+      MAX7219FrameWord(reg_number, dataout);
+    else
+      MAX7219FrameWord(REG_NOOP, 0);
+  }
+  MAX7219FrameLatch();
+  MAX7219_STATS_FRAME(2 * MAX7219ChainLength);
+  MAX7219_STATS_STOP(MAX7219_STATS_WRITE);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219WriteAll()
+*
+* Description: Write the same register of every chip in a single LOAD frame (queued instead inside
+*              MAX7219Begin()/MAX7219Commit()).
+* Arguments  : reg_number = register to write to
+*              dataout = data to write
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219WriteAll (unsigned char reg_number, unsigned char dataout) {
+  unsigned char i;
+
+  if (MAX7219InTransaction() && MAX7219ShadowDeferrable(reg_number)) {
+    MAX7219SetRegisterAll(reg_number, dataout);       // goes out with MAX7219Commit()
+    return;
+  }
+  MAX7219_STATS_START();
+  while (MAX7219FlushBusy())                          // don't cut into an asynchronous flush
+    ;
+  MAX7219FrameStart();
+  for (i = MAX7219ChainLength; i-- > 0; ) {
+    MAX7219ShadowUpdate(i, reg_number, dataout);
+    MAX7219_STATS_WORD(i, reg_number, dataout);
+    MAX7219FrameWord(reg_number, dataout);
+  }
+  MAX7219FrameLatch();
+  MAX7219_STATS_FRAME(2 * MAX7219ChainLength);
+  MAX7219_STATS_STOP(MAX7219_STATS_WRITE);
+}
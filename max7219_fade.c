@@ -0,0 +1,204 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_FADE.C
+* Description: MAX7219 gamma-corrected brightness fades (port independent)
+*
+*  The intensity register sets the LED duty cycle to (2 * intensity + 1) / 32, a linear step in light,
+*  but the eye sees equal ratios of light as equal steps: stepping the register 0, 1, 2, ... 15 at a
+*  steady pace looks fast at the dark end and slow at the bright end.  A fade therefore moves a
+*  perceived level (0-255) at a steady pace, and the register follows through a gamma 2.2 curve:
+*  level = 255 * ((2 * intensity + 1) / 31) ^ (1 / 2.2).
+*
+*  MAX7219FadeTick() advances every running fade by one tick; register it with the scheduler
+*  (MAX7219SchedAdd(MAX7219FadeTick, 1)) or call it from the main loop at a steady rate.  The
+*  intensity is written only when the curve crosses into the next of the 16 values, so a fade costs
+*  at most 16 register writes however many ticks it takes, and those go out with the next flush.
+*
+*  Each chip in the chain fades on its own.  The fade sets the intensity the application wants, so
+*  MAX7219SetAutoPower() still scales it to the scanned digits.  A fade starts from the intensity the
+*  last fade left; once fades are used, set the brightness with a fade of 0 ticks rather than with
+*  MAX7219SetBrightness().
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+#include "max7219_font.h"                             // FONT_ATTR, FONT_READ()
+
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+// Perceived level of each intensity, and the level from which the next intensity is the nearest.
+static const uint8_t MAX7219FadeLevel[16] FONT_ATTR = {
+   54,  88, 111, 130, 145, 159, 172, 183, 194, 204, 214, 223, 231, 239, 247, 255
+};
+static const uint8_t MAX7219FadeEdge[15] FONT_ATTR = {
+   71, 100, 121, 138, 152, 166, 178, 189, 199, 209, 219, 227, 235, 243, 251
+};
+
+static uint16_t      MAX7219FadeNow[MAX7219_CHAIN_MAX];     // perceived level, 8.8 fixed point
+static int16_t       MAX7219FadeStep[MAX7219_CHAIN_MAX];    // added every tick, 8.8 fixed point
+static unsigned int  MAX7219FadeLeft[MAX7219_CHAIN_MAX];    // ticks to go, 0 = not fading
+static unsigned char MAX7219FadeTarget[MAX7219_CHAIN_MAX];  // intensity at the end
+static unsigned char MAX7219FadeSent[MAX7219_CHAIN_MAX];    // intensity last written + 1, 0 = unknown
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static unsigned char MAX7219FadeQuantise (uint8_t level);
+static void MAX7219FadeWrite (unsigned char chip, unsigned char intensity);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219FadeChip()
+*
+* Description: Start fading one chip to a new intensity.  A fade already running on that chip is
+*              taken over from where it is.
+* Arguments  : chip = chip index (0 = nearest the MCU)
+*              intensity = target intensity (0-15)
+*              ticks = duration in MAX7219FadeTick() calls, 0 = at once
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219FadeChip (unsigned char chip, unsigned char intensity, unsigned int ticks) {
+  uint8_t from;
+  int16_t distance;
+
+  if (chip >= MAX7219_CHAIN_MAX)
+    return;
+  intensity &= 0x0f;
+  if (MAX7219FadeLeft[chip])
+    from = MAX7219FadeNow[chip] >> 8;
+  else if (MAX7219FadeSent[chip])
+    from = FONT_READ(&MAX7219FadeLevel[MAX7219FadeSent[chip] - 1]);
+  else
+    from = FONT_READ(&MAX7219FadeLevel[MAX7219GetWantedIntensity(chip)]);  // not the auto power level
+
+  MAX7219FadeTarget[chip] = intensity;
+  if (ticks == 0) {
+    MAX7219FadeLeft[chip] = 0;
+    MAX7219FadeWrite(chip, intensity);
+    return;
+  }
+  distance = (int16_t)FONT_READ(&MAX7219FadeLevel[intensity]) - from;
+  MAX7219FadeNow[chip]  = (uint16_t)from << 8;
+  MAX7219FadeStep[chip] = (int16_t)(((int32_t)distance << 8) / (int32_t)ticks);
+  MAX7219FadeLeft[chip] = ticks;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219Fade()
+*
+* Description: Start fading every chip in the chain to the same intensity.
+* Arguments  : intensity = target intensity (0-15)
+*              ticks = duration in MAX7219FadeTick() calls, 0 = at once
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219Fade (unsigned char intensity, unsigned int ticks) {
+  unsigned char chip;
+  for (chip = 0; chip < MAX7219GetChainLength(); chip++)
+    MAX7219FadeChip(chip, intensity, ticks);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FadeBusy()
+*
+* Description: Poll the fades.
+* Arguments  : chip = chip index, or MAX7219_FADE_ANY for the whole chain
+* Returns    : 1 while the fade of that chip (of any chip) is running, 0 once it has ended
+*********************************************************************************************************
+*/
+unsigned char MAX7219FadeBusy (unsigned char chip) {
+  if (chip != MAX7219_FADE_ANY)
+    return chip < MAX7219_CHAIN_MAX && MAX7219FadeLeft[chip] != 0;
+  for (chip = 0; chip < MAX7219_CHAIN_MAX; chip++)
+    if (MAX7219FadeLeft[chip])
+      return 1;
+  return 0;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FadeTick()
+*
+* Description: Advance every running fade by one tick.  Only intensities that change are written to
+*              the shadow registers; MAX7219Flush() (or the scheduler) sends them.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219FadeTick (void) {
+  unsigned char chip, intensity;
+
+  for (chip = 0; chip < MAX7219_CHAIN_MAX; chip++) {
+    if (MAX7219FadeLeft[chip] == 0)
+      continue;
+    if (--MAX7219FadeLeft[chip] == 0)
+      intensity = MAX7219FadeTarget[chip];            // land exactly, whatever the rounding
+    else {
+      MAX7219FadeNow[chip] += MAX7219FadeStep[chip];
+      intensity = MAX7219FadeQuantise(MAX7219FadeNow[chip] >> 8);
+    }
+    MAX7219FadeWrite(chip, intensity);
+  }
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219FadeQuantise()
+*
+* Description: Find the intensity whose perceived level is nearest to a level.
+*********************************************************************************************************
+*/
+static unsigned char MAX7219FadeQuantise (uint8_t level) {
+  unsigned char intensity = 0;
+
+  while (intensity < 15 && level >= FONT_READ(&MAX7219FadeEdge[intensity]))
+    intensity++;
+  return intensity;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FadeWrite()
+*
+* Description: Set the intensity of a chip unless the fade already set it to that value.
+*********************************************************************************************************
+*/
+static void MAX7219FadeWrite (unsigned char chip, unsigned char intensity) {
+  if (intensity + 1 == MAX7219FadeSent[chip])
+    return;
+  MAX7219FadeSent[chip] = intensity + 1;
+  MAX7219SetRegisterChip(chip, REG_INTENSITY, intensity);
+}
@@ -0,0 +1,105 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_FONT.C
+* Description: 7-segment font table shared by MAX7219.C and MAX7219_32.C (see MAX7219_FONT.H)
+*
+*  The entries are MAX7219_FONT_GLYPHS (MAX7219_FONT.H), built from the SEG_x bits, so the whole
+*  table is a compile-time constant.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219_font.h"
+
+
+/*
+*********************************************************************************************************
+* Public Data
+*********************************************************************************************************
+*/
+const uint8_t MAX7219Font[FONT_LAST - FONT_FIRST + 1] FONT_ATTR = {
+  MAX7219_FONT_GLYPHS
+};
+
+#if MAX7219_FONT_CUSTOM
+unsigned char MAX7219FontCustomCount;
+char    MAX7219FontCustomChar[MAX7219_FONT_CUSTOM];
+uint8_t MAX7219FontCustomGlyph[MAX7219_FONT_CUSTOM];
+#endif
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219FontDefine()
+*
+* Description: Give a character a custom glyph, or replace its custom glyph.  It takes effect on the
+*              next MAX7219DisplayChar() (or string, scroll) with that character; digits already
+*              showing it are not redrawn.
+* Arguments  : character = any character, inside ' '..'~' to override the table or outside it for a
+*                          new symbol (e.g. '\x01')
+*              segments = SEG_x bits OR'ed together
+* Returns    : 1 on success, 0 if MAX7219_FONT_CUSTOM glyphs are already defined
+*********************************************************************************************************
+*/
+unsigned char MAX7219FontDefine (char character, uint8_t segments) {
+#if MAX7219_FONT_CUSTOM
+  unsigned char i;
+
+  for (i = 0; i < MAX7219FontCustomCount; i++)
+    if (MAX7219FontCustomChar[i] == character)
+      break;
+  if (i == MAX7219_FONT_CUSTOM)
+    return 0;
+  MAX7219FontCustomGlyph[i] = segments;               // glyph before character: an interrupt
+  MAX7219FontCustomChar[i]  = character;              // drawing it never sees a stale code
+  if (i == MAX7219FontCustomCount)
+    MAX7219FontCustomCount++;
+  return 1;
+#else
+  (void)character;
+  (void)segments;
+  return 0;
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FontUndefine()
+*
+* Description: Remove a custom glyph; the character shows its table glyph (or blank) again.
+* Arguments  : character = character given to MAX7219FontDefine()
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219FontUndefine (char character) {
+#if MAX7219_FONT_CUSTOM
+  unsigned char i, last;
+
+  for (i = 0; i < MAX7219FontCustomCount; i++) {
+    if (MAX7219FontCustomChar[i] == character) {
+      last = --MAX7219FontCustomCount;                // move the last glyph into the gap
+      MAX7219FontCustomChar[i]  = MAX7219FontCustomChar[last];
+      MAX7219FontCustomGlyph[i] = MAX7219FontCustomGlyph[last];
+      return;
+    }
+  }
+#else
+  (void)character;
+#endif
+}
@@ -0,0 +1,279 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_FONT.H
+* Description: 7-segment font shared by MAX7219.C and MAX7219_32.C
+*
+*  The font is one table indexed directly by character code, ' ' (0x20) to '~' (0x7e), including
+*  lowercase forms.  MAX7219FontGlyph() is a bounds check and a single load; any character outside the
+*  table shows as blank.
+*
+*  Segment wiring: the table is built from the SEG_x bits below, which assume the usual module wiring
+*  (dp a b c d e f g from bit 7 down).  A board wired in another order names a header that defines
+*  all eight SEG_x for its wiring, e.g. -DMAX7219_BOARD_SEGMENTS=\"board_segments.h\" with
+*
+*    #define SEG_DP 0x01
+*    #define SEG_A  0x02
+*    ...
+*
+*  and the compiler builds the table in that order; nothing changes at run time.  The Code-B digits
+*  are decoded by the chip and always use the standard order.
+*
+*  Custom glyphs: MAX7219FontDefine() gives any character (e.g. '\x01' for an arrow or a unit) its
+*  own segment code at run time.  The MAX7219_FONT_CUSTOM defined glyphs sit in RAM and are checked
+*  before the table; with none defined the check is one compare.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+#ifndef _MAX7219_FONT_H
+#define _MAX7219_FONT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+*********************************************************************************************************
+* LED Segments:         a
+*                     ----
+*                   f|    |b
+*                    |  g |
+*                     ----
+*                   e|    |c
+*                    |    |
+*                     ----  o dp
+*                       d
+*   Register bits:
+*      bit:  7  6  5  4  3  2  1  0
+*           dp  a  b  c  d  e  f  g
+*********************************************************************************************************
+*/
+#ifdef MAX7219_BOARD_SEGMENTS
+#include MAX7219_BOARD_SEGMENTS                       // board segment wiring
+#endif
+
+#ifndef SEG_A
+#define SEG_DP            0x80
+#define SEG_A             0x40
+#define SEG_B             0x20
+#define SEG_C             0x10
+#define SEG_D             0x08
+#define SEG_E             0x04
+#define SEG_F             0x02
+#define SEG_G             0x01
+#endif
+
+#define SEG_ONE_BIT(x)    ((x) != 0 && ((x) & ((x) - 1)) == 0)
+
+#if !SEG_ONE_BIT(SEG_DP) || !SEG_ONE_BIT(SEG_A) || !SEG_ONE_BIT(SEG_B) || !SEG_ONE_BIT(SEG_C) || \
+    !SEG_ONE_BIT(SEG_D) || !SEG_ONE_BIT(SEG_E) || !SEG_ONE_BIT(SEG_F) || !SEG_ONE_BIT(SEG_G) || \
+    (SEG_DP | SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G) != 0xff
+#error "SEG_DP and SEG_A-SEG_G must each be a different single bit"
+#endif
+#undef SEG_ONE_BIT
+
+// Code-B font of the chip's own decoder (digits in decode mode take a 4-bit code, dp in bit 7).
+#define CODEB_DP          0x80
+#define CODEB_DASH        0x0a
+#define CODEB_E           0x0b
+#define CODEB_H           0x0c
+#define CODEB_L           0x0d
+#define CODEB_P           0x0e
+#define CODEB_BLANK       0x0f
+
+#define FONT_FIRST        ' '                         // first character in the table
+#define FONT_LAST         '~'                         // last character in the table
+
+// Glyphs of FONT_FIRST to FONT_LAST: the initializer of the table in MAX7219_FONT.C and of the
+// constexpr table in MAX7219.HPP.  Some characters have no good 7-segment form and share a glyph
+// with a look-alike (e.g. 'S' and '5').  To display more, change the entries here, or define
+// glyphs at run time with MAX7219FontDefine().
+#define MAX7219_FONT_GLYPHS                                                           \
+  0,                                              /* space */                         \
+  SEG_DP|SEG_B|SEG_C,                             /* ! */                             \
+  SEG_B|SEG_F,                                    /* " */                             \
+  SEG_B|SEG_C|SEG_E|SEG_F,                        /* # */                             \
+  SEG_A|SEG_C|SEG_D|SEG_F|SEG_G,                  /* $ */                             \
+  SEG_B|SEG_E,                                    /* % */                             \
+  SEG_A|SEG_B|SEG_D|SEG_E|SEG_F|SEG_G,            /* & */                             \
+  SEG_F,                                          /* ' (single quote) */              \
+  SEG_A|SEG_D|SEG_E|SEG_F,                        /* ( */                             \
+  SEG_A|SEG_B|SEG_C|SEG_D,                        /* ) */                             \
+  SEG_A|SEG_B|SEG_F|SEG_G,                        /* * */                             \
+  SEG_B|SEG_C|SEG_G,                              /* + */                             \
+  SEG_C,                                          /* , */                             \
+  SEG_G,                                          /* - */                             \
+  SEG_DP,                                         /* . or dp */                       \
+  SEG_B|SEG_E|SEG_G,                              /* / */                             \
+  SEG_A|SEG_B|SEG_C|SEG_D|SEG_E|SEG_F,            /* 0 */                             \
+  SEG_B|SEG_C,                                    /* 1 */                             \
+  SEG_A|SEG_B|SEG_D|SEG_E|SEG_G,                  /* 2 */                             \
+  SEG_A|SEG_B|SEG_C|SEG_D|SEG_G,                  /* 3 */                             \
+  SEG_B|SEG_C|SEG_F|SEG_G,                        /* 4 */                             \
+  SEG_A|SEG_C|SEG_D|SEG_F|SEG_G,                  /* 5 */                             \
+  SEG_A|SEG_C|SEG_D|SEG_E|SEG_F|SEG_G,            /* 6 */                             \
+  SEG_A|SEG_B|SEG_C,                              /* 7 */                             \
+  SEG_A|SEG_B|SEG_C|SEG_D|SEG_E|SEG_F|SEG_G,      /* 8 */                             \
+  SEG_A|SEG_B|SEG_C|SEG_D|SEG_F|SEG_G,            /* 9 */                             \
+  SEG_A|SEG_D,                                    /* : */                             \
+  SEG_D|SEG_F,                                    /* ; */                             \
+  SEG_A|SEG_F|SEG_G,                              /* < */                             \
+  SEG_D|SEG_G,                                    /* = */                             \
+  SEG_A|SEG_B|SEG_G,                              /* > */                             \
+  SEG_A|SEG_B|SEG_E|SEG_G,                        /* ? */                             \
+  SEG_A|SEG_B|SEG_C|SEG_D|SEG_E|SEG_G,            /* @ */                             \
+  SEG_A|SEG_B|SEG_C|SEG_E|SEG_F|SEG_G,            /* A */                             \
+  SEG_C|SEG_D|SEG_E|SEG_F|SEG_G,                  /* B */                             \
+  SEG_A|SEG_D|SEG_E|SEG_F,                        /* C */                             \
+  SEG_B|SEG_C|SEG_D|SEG_E|SEG_G,                  /* D */                             \
+  SEG_A|SEG_D|SEG_E|SEG_F|SEG_G,                  /* E */                             \
+  SEG_A|SEG_E|SEG_F|SEG_G,                        /* F */                             \
+  SEG_A|SEG_C|SEG_D|SEG_E|SEG_F,                  /* G */                             \
+  SEG_B|SEG_C|SEG_E|SEG_F|SEG_G,                  /* H */                             \
+  SEG_E|SEG_F,                                    /* I */                             \
+  SEG_B|SEG_C|SEG_D|SEG_E,                        /* J */                             \
+  SEG_A|SEG_C|SEG_E|SEG_F|SEG_G,                  /* K */                             \
+  SEG_D|SEG_E|SEG_F,                              /* L */                             \
+  SEG_A|SEG_B|SEG_C|SEG_E|SEG_F,                  /* M */                             \
+  SEG_A|SEG_B|SEG_C|SEG_E|SEG_F,                  /* N */                             \
+  SEG_A|SEG_B|SEG_C|SEG_D|SEG_E|SEG_F,            /* O */                             \
+  SEG_A|SEG_B|SEG_E|SEG_F|SEG_G,                  /* P */                             \
+  SEG_A|SEG_B|SEG_C|SEG_F|SEG_G,                  /* Q */                             \
+  SEG_E|SEG_G,                                    /* R */                             \
+  SEG_A|SEG_C|SEG_D|SEG_F|SEG_G,                  /* S */                             \
+  SEG_D|SEG_E|SEG_F|SEG_G,                        /* T */                             \
+  SEG_B|SEG_C|SEG_D|SEG_E|SEG_F,                  /* U */                             \
+  SEG_B|SEG_C|SEG_D|SEG_E|SEG_F,                  /* V */                             \
+  SEG_B|SEG_D|SEG_F,                              /* W */                             \
+  SEG_B|SEG_C|SEG_E|SEG_F|SEG_G,                  /* X */                             \
+  SEG_B|SEG_C|SEG_D|SEG_F|SEG_G,                  /* Y */                             \
+  SEG_A|SEG_B|SEG_D|SEG_E|SEG_G,                  /* Z */                             \
+  SEG_A|SEG_D|SEG_E|SEG_F,                        /* [ */                             \
+  SEG_C|SEG_F|SEG_G,                              /* \ back slash */                  \
+  SEG_A|SEG_B|SEG_C|SEG_D,                        /* ] */                             \
+  SEG_A|SEG_B|SEG_F,                              /* ^ */                             \
+  SEG_D,                                          /* _ */                             \
+  SEG_B,                                          /* ` */                             \
+  SEG_A|SEG_B|SEG_C|SEG_D|SEG_E|SEG_G,            /* a */                             \
+  SEG_C|SEG_D|SEG_E|SEG_F|SEG_G,                  /* b */                             \
+  SEG_D|SEG_E|SEG_G,                              /* c */                             \
+  SEG_B|SEG_C|SEG_D|SEG_E|SEG_G,                  /* d */                             \
+  SEG_A|SEG_B|SEG_D|SEG_E|SEG_F|SEG_G,            /* e */                             \
+  SEG_A|SEG_E|SEG_F|SEG_G,                        /* f */                             \
+  SEG_A|SEG_B|SEG_C|SEG_D|SEG_F|SEG_G,            /* g */                             \
+  SEG_C|SEG_E|SEG_F|SEG_G,                        /* h */                             \
+  SEG_C,                                          /* i */                             \
+  SEG_B|SEG_C|SEG_D,                              /* j */                             \
+  SEG_A|SEG_C|SEG_E|SEG_F|SEG_G,                  /* k */                             \
+  SEG_E|SEG_F,                                    /* l */                             \
+  SEG_C|SEG_E|SEG_G,                              /* m */                             \
+  SEG_C|SEG_E|SEG_G,                              /* n */                             \
+  SEG_C|SEG_D|SEG_E|SEG_G,                        /* o */                             \
+  SEG_A|SEG_B|SEG_E|SEG_F|SEG_G,                  /* p */                             \
+  SEG_A|SEG_B|SEG_C|SEG_F|SEG_G,                  /* q */                             \
+  SEG_E|SEG_G,                                    /* r */                             \
+  SEG_A|SEG_C|SEG_D|SEG_F|SEG_G,                  /* s */                             \
+  SEG_D|SEG_E|SEG_F|SEG_G,                        /* t */                             \
+  SEG_C|SEG_D|SEG_E,                              /* u */                             \
+  SEG_C|SEG_D|SEG_E,                              /* v */                             \
+  SEG_B|SEG_D|SEG_F,                              /* w */                             \
+  SEG_B|SEG_C|SEG_E|SEG_F|SEG_G,                  /* x */                             \
+  SEG_B|SEG_C|SEG_D|SEG_F|SEG_G,                  /* y */                             \
+  SEG_A|SEG_B|SEG_D|SEG_E|SEG_G,                  /* z */                             \
+  SEG_A|SEG_D|SEG_E|SEG_F,                        /* { */                             \
+  SEG_E|SEG_F,                                    /* | */                             \
+  SEG_A|SEG_B|SEG_C|SEG_D,                        /* } */                             \
+  SEG_A,                                          /* ~ */
+
+#ifndef MAX7219_FONT_CUSTOM
+#define MAX7219_FONT_CUSTOM  4                        // custom glyphs; 0 = no RAM overlay
+#endif
+
+// The ATmega keeps the table in flash; AVR32 (and the host) read flash as ordinary memory.
+#if defined(__AVR__) && !defined(__AVR32__)
+#include <avr/pgmspace.h>
+#define FONT_ATTR         PROGMEM
+#define FONT_READ(addr)   pgm_read_byte(addr)
+#else
+#define FONT_ATTR
+#define FONT_READ(addr)   (*(addr))
+#endif
+
+/*
+*********************************************************************************************************
+* Public Data
+*********************************************************************************************************
+*/
+extern const uint8_t MAX7219Font[FONT_LAST - FONT_FIRST + 1] FONT_ATTR;  // MAX7219_FONT.C
+#if MAX7219_FONT_CUSTOM
+extern unsigned char MAX7219FontCustomCount;          // custom glyphs defined
+extern char    MAX7219FontCustomChar[MAX7219_FONT_CUSTOM];   // their characters
+extern uint8_t MAX7219FontCustomGlyph[MAX7219_FONT_CUSTOM];  // their segment codes
+#endif
+
+/*
+*********************************************************************************************************
+* Public Function Prototypes (MAX7219_FONT.C)
+*********************************************************************************************************
+*/
+unsigned char MAX7219FontDefine (char character, uint8_t segments);
+void MAX7219FontUndefine (char character);
+
+/*
+*********************************************************************************************************
+* MAX7219FontGlyph()
+*
+* Description: Convert a character to its 7-segment code, a custom glyph first.
+* Arguments  : character = character to display
+* Returns    : segment code, 0 (blank) for characters outside ' '..'~' without a custom glyph
+*********************************************************************************************************
+*/
+static inline uint8_t MAX7219FontGlyph (char character) {
+  uint8_t index = (uint8_t)character - FONT_FIRST;    // characters below ' ' wrap to a large index
+#if MAX7219_FONT_CUSTOM
+  unsigned char i;
+
+  for (i = 0; i < MAX7219FontCustomCount; i++)
+    if (MAX7219FontCustomChar[i] == character)
+      return MAX7219FontCustomGlyph[i];
+#endif
+  if (index > FONT_LAST - FONT_FIRST)
+    return 0;
+  return FONT_READ(&MAX7219Font[index]);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FontCodeB()
+*
+* Description: Convert a character to the Code-B value for a digit in decode mode.  No table: the chip
+*              holds the font.
+* Arguments  : character = '0'-'9', '-', 'E', 'H', 'L', 'P' (either case) or ' '
+* Returns    : Code-B value, CODEB_BLANK for characters Code-B cannot show
+*********************************************************************************************************
+*/
+static inline uint8_t MAX7219FontCodeB (char character) {
+  if (character >= '0' && character <= '9')
+    return character - '0';
+  switch (character) {
+    case '-':           return CODEB_DASH;
+    case 'E': case 'e': return CODEB_E;
+    case 'H': case 'h': return CODEB_H;
+    case 'L': case 'l': return CODEB_L;
+    case 'P': case 'p': return CODEB_P;
+    default:            return CODEB_BLANK;
+  }
+}
+#ifdef __cplusplus
+}
+#endif
+#endif // _MAX7219_FONT_H
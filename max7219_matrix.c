@@ -0,0 +1,374 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_MATRIX.C
+* Description: MAX7219 8x8 LED matrix mode (port independent)
+*
+*  In a matrix module the eight digit registers are the eight rows and the eight segment bits of a
+*  register are the columns.  Each chip's image is kept here as one 64-bit bitmap: bit 8 * y + x is the
+*  pixel in column x of row y, so byte y is exactly what goes into digit register y + 1.
+*
+*  Whole-image operations (invert, shift, transpose, mirror, rotate) work on all 64 pixels at once
+*  with masks and shifts, a fixed handful of operations instead of a loop over the pixels.
+*
+*  Modules mounted turned or mirrored are handled by MAX7219MatrixSetOrientation(): the application
+*  draws upright and MAX7219MatrixShow() turns each image on the way to the shadow registers.  As with
+*  the 7-segment functions, MAX7219Flush() then sends the rows that changed.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define MATRIX_BYTE_LSB   0x0101010101010101ULL       // bit 0 of every row
+#define MATRIX_ROT_MASK   0x03                        // quarter turns in an orientation
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static uint64_t      MAX7219MatrixImage[MAX7219_CHAIN_MAX];        // upright image of each chip
+static unsigned char MAX7219MatrixOrient[MAX7219_CHAIN_MAX];       // mounting of each chip
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static uint64_t MAX7219MatrixTransposeBits (uint64_t image);
+static uint64_t MAX7219MatrixMirrorBits (uint64_t image);
+static uint64_t MAX7219MatrixFlipBits (uint64_t image);
+static uint64_t MAX7219MatrixRotateBits (uint64_t image, unsigned char turns);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixSetOrientation()
+*
+* Description: Tell the driver how a matrix module is mounted.
+* Arguments  : chip = chip index (0 = nearest the MCU)
+*              orientation = MAX7219_MATRIX_ROT0/90/180/270, optionally OR'ed with
+*                            MAX7219_MATRIX_MIRROR; the image is mirrored first, then turned clockwise
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixSetOrientation (unsigned char chip, unsigned char orientation) {
+  if (chip < MAX7219_CHAIN_MAX)
+    MAX7219MatrixOrient[chip] = orientation;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixSet()
+*
+* Description: Replace the whole image of a chip.
+* Arguments  : chip = chip index
+*              image = bitmap, byte y = row y, bit x of it = column x
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixSet (unsigned char chip, uint64_t image) {
+  if (chip < MAX7219_CHAIN_MAX)
+    MAX7219MatrixImage[chip] = image;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixGet()
+*
+* Description: Read back the image of a chip.
+* Arguments  : chip = chip index
+* Returns    : bitmap, 0 for a chip outside the chain
+*********************************************************************************************************
+*/
+uint64_t MAX7219MatrixGet (unsigned char chip) {
+  if (chip >= MAX7219_CHAIN_MAX)
+    return 0;
+  return MAX7219MatrixImage[chip];
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixSetPixel()
+*
+* Description: Light or clear one pixel.
+* Arguments  : chip = chip index
+*              x = column 0-7
+*              y = row 0-7
+*              on = 1 to light the pixel, 0 to clear it
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixSetPixel (unsigned char chip, unsigned char x, unsigned char y, unsigned char on) {
+  uint64_t bit;
+
+  if (chip >= MAX7219_CHAIN_MAX || x > 7 || y > 7)
+    return;
+  bit = (uint64_t)1 << (8 * y + x);
+  if (on)
+    MAX7219MatrixImage[chip] |= bit;
+  else
+    MAX7219MatrixImage[chip] &= ~bit;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixGetPixel()
+*
+* Description: Read one pixel.
+* Arguments  : chip = chip index
+*              x = column 0-7
+*              y = row 0-7
+* Returns    : 1 = lit, 0 = dark or outside the matrix
+*********************************************************************************************************
+*/
+unsigned char MAX7219MatrixGetPixel (unsigned char chip, unsigned char x, unsigned char y) {
+  if (chip >= MAX7219_CHAIN_MAX || x > 7 || y > 7)
+    return 0;
+  return (MAX7219MatrixImage[chip] >> (8 * y + x)) & 1;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixFill()
+*
+* Description: Light (or clear) every pixel of a chip.
+* Arguments  : chip = chip index
+*              on = 1 to light everything, 0 to clear
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixFill (unsigned char chip, unsigned char on) {
+  MAX7219MatrixSet(chip, on ? ~(uint64_t)0 : 0);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixInvert()
+*
+* Description: Invert every pixel of a chip.
+* Arguments  : chip = chip index
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixInvert (unsigned char chip) {
+  if (chip < MAX7219_CHAIN_MAX)
+    MAX7219MatrixImage[chip] = ~MAX7219MatrixImage[chip];
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixShift()
+*
+* Description: Move the image of a chip; pixels shifted out are lost, dark pixels come in.
+* Arguments  : chip = chip index
+*              dx = columns to move, positive towards higher x
+*              dy = rows to move, positive towards higher y
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixShift (unsigned char chip, signed char dx, signed char dy) {
+  uint64_t image;
+
+  if (chip >= MAX7219_CHAIN_MAX)
+    return;
+  image = MAX7219MatrixImage[chip];
+  if (dx >= 8 || dx <= -8 || dy >= 8 || dy <= -8) {
+    image = 0;
+  } else {
+    if (dx > 0)                                       // the mask keeps bits from crossing into the next row
+      image = (image << dx) & (MATRIX_BYTE_LSB * (uint8_t)(0xff << dx));
+    else if (dx < 0)
+      image = (image >> -dx) & (MATRIX_BYTE_LSB * (uint8_t)(0xff >> -dx));
+    if (dy > 0)
+      image <<= 8 * dy;
+    else if (dy < 0)
+      image >>= 8 * -dy;
+  }
+  MAX7219MatrixImage[chip] = image;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixTranspose()
+*
+* Description: Swap rows and columns of a chip's image (mirror along the x = y diagonal).
+* Arguments  : chip = chip index
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixTranspose (unsigned char chip) {
+  if (chip < MAX7219_CHAIN_MAX)
+    MAX7219MatrixImage[chip] = MAX7219MatrixTransposeBits(MAX7219MatrixImage[chip]);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixMirror()
+*
+* Description: Mirror a chip's image left to right (column x becomes column 7 - x).
+* Arguments  : chip = chip index
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixMirror (unsigned char chip) {
+  if (chip < MAX7219_CHAIN_MAX)
+    MAX7219MatrixImage[chip] = MAX7219MatrixMirrorBits(MAX7219MatrixImage[chip]);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixFlip()
+*
+* Description: Flip a chip's image top to bottom (row y becomes row 7 - y).
+* Arguments  : chip = chip index
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixFlip (unsigned char chip) {
+  if (chip < MAX7219_CHAIN_MAX)
+    MAX7219MatrixImage[chip] = MAX7219MatrixFlipBits(MAX7219MatrixImage[chip]);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixRotate()
+*
+* Description: Turn a chip's image clockwise.
+* Arguments  : chip = chip index
+*              turns = quarter turns, 0-3
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixRotate (unsigned char chip, unsigned char turns) {
+  if (chip < MAX7219_CHAIN_MAX)
+    MAX7219MatrixImage[chip] = MAX7219MatrixRotateBits(MAX7219MatrixImage[chip], turns);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixShow()
+*
+* Description: Copy every chip's image, turned to its orientation, into the digit registers of the
+*              shadow copy.  MAX7219Flush() sends the rows that changed.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219MatrixShow (void) {
+  unsigned char chip, row;
+  uint64_t image;
+
+  for (chip = 0; chip < MAX7219GetChainLength(); chip++) {
+    image = MAX7219MatrixImage[chip];
+    if (MAX7219MatrixOrient[chip] & MAX7219_MATRIX_MIRROR)
+      image = MAX7219MatrixMirrorBits(image);
+    image = MAX7219MatrixRotateBits(image, MAX7219MatrixOrient[chip] & MATRIX_ROT_MASK);
+    for (row = 0; row < 8; row++, image >>= 8)
+      MAX7219SetRegisterChip(chip, REG_DIGIT0 + row, (unsigned char)image);
+  }
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixTransposeBits()
+*
+* Description: Transpose an 8x8 bitmap in three delta swaps: 1x1 blocks inside 2x2 blocks, then 2x2
+*              inside 4x4, then 4x4 inside the full 8x8.
+*********************************************************************************************************
+*/
+static uint64_t MAX7219MatrixTransposeBits (uint64_t image) {
+  uint64_t t;
+
+  t = (image ^ (image >> 7))  & 0x00aa00aa00aa00aaULL;
+  image ^= t ^ (t << 7);
+  t = (image ^ (image >> 14)) & 0x0000cccc0000ccccULL;
+  image ^= t ^ (t << 14);
+  t = (image ^ (image >> 28)) & 0x00000000f0f0f0f0ULL;
+  image ^= t ^ (t << 28);
+  return image;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixMirrorBits()
+*
+* Description: Reverse the bit order within every row: swap neighbouring bits, pairs, then nibbles.
+*********************************************************************************************************
+*/
+static uint64_t MAX7219MatrixMirrorBits (uint64_t image) {
+  image = ((image >> 1) & 0x5555555555555555ULL) | ((image & 0x5555555555555555ULL) << 1);
+  image = ((image >> 2) & 0x3333333333333333ULL) | ((image & 0x3333333333333333ULL) << 2);
+  image = ((image >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((image & 0x0f0f0f0f0f0f0f0fULL) << 4);
+  return image;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixFlipBits()
+*
+* Description: Reverse the row order: swap neighbouring rows, pairs, then halves.
+*********************************************************************************************************
+*/
+static uint64_t MAX7219MatrixFlipBits (uint64_t image) {
+  image = ((image >> 8)  & 0x00ff00ff00ff00ffULL) | ((image & 0x00ff00ff00ff00ffULL) << 8);
+  image = ((image >> 16) & 0x0000ffff0000ffffULL) | ((image & 0x0000ffff0000ffffULL) << 16);
+  image = (image >> 32) | (image << 32);
+  return image;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219MatrixRotateBits()
+*
+* Description: Turn a bitmap clockwise by quarter turns.  A quarter turn is a transpose followed by a
+*              mirror, half a turn is a mirror and a flip.
+*********************************************************************************************************
+*/
+static uint64_t MAX7219MatrixRotateBits (uint64_t image, unsigned char turns) {
+  switch (turns & MATRIX_ROT_MASK) {
+    case 1:  return MAX7219MatrixMirrorBits(MAX7219MatrixTransposeBits(image));
+    case 2:  return MAX7219MatrixFlipBits(MAX7219MatrixMirrorBits(image));
+    case 3:  return MAX7219MatrixFlipBits(MAX7219MatrixTransposeBits(image));
+    default: return image;
+  }
+}
@@ -0,0 +1,241 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_QUEUE.C
+* Description: MAX7219 command rings for updating the display from interrupts (port independent)
+*
+*  The driver itself is not reentrant: an interrupt that writes to the MAX7219 while the main loop is
+*  in the middle of a frame corrupts both.  Instead of masking interrupts around every driver call,
+*  writers put register updates in a ring and exactly one context (the "drain", usually the main
+*  loop) calls MAX7219QueueDrain(), which moves them into the shadow registers and flushes.  Only the
+*  drain ever touches the bus, so no frame can be torn.
+*
+*  Two rings:
+*    MAX7219QueuePut()      single producer: one context (e.g. one interrupt handler) writes.  Head
+*                           and tail are single bytes owned by one side each, so neither side waits.
+*    MAX7219QueuePutMulti() any number of producers.  A writer claims a slot by advancing the head
+*                           atomically, fills it and then marks it ready; the drain stops at the first
+*                           slot that is claimed but not ready yet.  The ATmega and the UC3L have no
+*                           compare-and-swap, so there the claim alone (a few instructions) runs with
+*                           interrupts masked; the host build uses the compiler's atomic builtins.
+*
+*  A full ring drops the update and the put returns 0; size the rings with MAX7219_QUEUE_SIZE.
+*  host/max7219_queuestress.c runs both rings from threads against the simulated bus.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+
+#if defined(__AVR32__)
+#include "compiler.h"                                 // Disable_global_interrupt()
+#elif defined(__AVR__)
+#include <avr/io.h>                                   // SREG
+#include <avr/interrupt.h>
+#endif
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define QUEUE_MASK        (MAX7219_QUEUE_SIZE - 1)
+
+#if (MAX7219_QUEUE_SIZE & QUEUE_MASK) != 0 || MAX7219_QUEUE_SIZE > 128
+#error "MAX7219_QUEUE_SIZE must be a power of two, at most 128"
+#endif
+
+// Keeps the slot contents and the index update in program order.  On the single core MCUs only the
+// compiler can reorder; on the host the threads also need a hardware fence.
+#if defined(__AVR__) || defined(__AVR32__)
+#define QUEUE_BARRIER()   __asm__ __volatile__ ("" ::: "memory")
+#else
+#define QUEUE_BARRIER()   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+struct max7219_cmd {
+  unsigned char chip;
+  unsigned char reg_number;
+  unsigned char data;
+  volatile unsigned char ready;                       // multi-producer ring: slot filled
+};
+
+static struct max7219_cmd MAX7219Ring[MAX7219_QUEUE_SIZE];       // single producer ring
+static volatile unsigned char MAX7219RingHead;        // written by the producer only
+static volatile unsigned char MAX7219RingTail;        // written by the drain only
+
+static struct max7219_cmd MAX7219MultiRing[MAX7219_QUEUE_SIZE];  // multi-producer ring
+static volatile unsigned char MAX7219MultiHead;       // next slot to claim
+static volatile unsigned char MAX7219MultiTail;       // written by the drain only
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static unsigned char MAX7219MultiClaim (unsigned char *slot);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219QueuePut()
+*
+* Description: Queue a register update from the single producer context.
+* Arguments  : chip = chip index (0 = nearest the MCU)
+*              reg_number = register to update
+*              data = new register value
+* Returns    : 1 = queued, 0 = ring full, update dropped
+*********************************************************************************************************
+*/
+unsigned char MAX7219QueuePut (unsigned char chip, unsigned char reg_number, unsigned char data) {
+  unsigned char head = MAX7219RingHead;
+  struct max7219_cmd *cmd;
+
+  if ((unsigned char)(head - MAX7219RingTail) >= MAX7219_QUEUE_SIZE)
+    return 0;
+  cmd = &MAX7219Ring[head & QUEUE_MASK];
+  cmd->chip       = chip;
+  cmd->reg_number = reg_number;
+  cmd->data       = data;
+  QUEUE_BARRIER();                                    // slot complete before the drain can see it
+  MAX7219RingHead = head + 1;
+  return 1;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219QueuePutMulti()
+*
+* Description: Queue a register update from any context; several may call this at the same time.
+* Arguments  : chip = chip index (0 = nearest the MCU)
+*              reg_number = register to update
+*              data = new register value
+* Returns    : 1 = queued, 0 = ring full, update dropped
+*********************************************************************************************************
+*/
+unsigned char MAX7219QueuePutMulti (unsigned char chip, unsigned char reg_number, unsigned char data) {
+  unsigned char slot;
+  struct max7219_cmd *cmd;
+
+  if (!MAX7219MultiClaim(&slot))
+    return 0;
+  cmd = &MAX7219MultiRing[slot & QUEUE_MASK];
+  cmd->chip       = chip;
+  cmd->reg_number = reg_number;
+  cmd->data       = data;
+  QUEUE_BARRIER();
+  cmd->ready = 1;                                     // hand the slot to the drain
+  return 1;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219QueueDrain()
+*
+* Description: Move the queued updates into the shadow registers, in order, and flush them.  Only the
+*              entries already queued when the drain starts are taken, so producers that keep posting
+*              cannot hold it in the loop; what they add meanwhile waits for the next call.  Call from
+*              one context only, the only one that uses the rest of the driver.
+* Arguments  : none
+* Returns    : number of updates taken from the rings, at most 2 * MAX7219_QUEUE_SIZE
+*********************************************************************************************************
+*/
+unsigned int MAX7219QueueDrain (void) {
+  unsigned int count = 0;
+  unsigned char tail, head;
+  struct max7219_cmd *cmd;
+
+  head = MAX7219RingHead;
+  for (tail = MAX7219RingTail; tail != head; tail++, count++) {
+    QUEUE_BARRIER();                                  // read the slot only after seeing the head
+    cmd = &MAX7219Ring[tail & QUEUE_MASK];
+    MAX7219SetRegisterChip(cmd->chip, cmd->reg_number, cmd->data);
+    QUEUE_BARRIER();                                  // done with the slot before giving it back
+    MAX7219RingTail = tail + 1;
+  }
+
+  head = MAX7219MultiHead;
+  for (tail = MAX7219MultiTail; tail != head; tail++, count++) {
+    cmd = &MAX7219MultiRing[tail & QUEUE_MASK];
+    if (!cmd->ready)                                  // a writer is still filling it
+      break;
+    QUEUE_BARRIER();
+    MAX7219SetRegisterChip(cmd->chip, cmd->reg_number, cmd->data);
+    cmd->ready = 0;
+    QUEUE_BARRIER();
+    MAX7219MultiTail = tail + 1;
+  }
+
+  if (count)
+    MAX7219Flush();
+  return count;
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219MultiClaim()
+*
+* Description: Claim the next free slot of the multi-producer ring.
+* Arguments  : slot = receives the claimed index
+* Returns    : 1 = claimed, 0 = ring full
+*********************************************************************************************************
+*/
+static unsigned char MAX7219MultiClaim (unsigned char *slot) {
+#if defined(__AVR__) || defined(__AVR32__)
+  unsigned char head, claimed = 0;
+#if defined(__AVR32__)
+  unsigned char enabled = Is_global_interrupt_enabled();
+  Disable_global_interrupt();
+#else
+  uint8_t sreg = SREG;
+  cli();
+#endif
+  head = MAX7219MultiHead;
+  if ((unsigned char)(head - MAX7219MultiTail) < MAX7219_QUEUE_SIZE) {
+    MAX7219MultiHead = head + 1;
+    *slot = head;
+    claimed = 1;
+  }
+#if defined(__AVR32__)
+  if (enabled)
+    Enable_global_interrupt();
+#else
+  SREG = sreg;
+#endif
+  return claimed;
+#else
+  unsigned char head = __atomic_load_n(&MAX7219MultiHead, __ATOMIC_ACQUIRE);
+  do {
+    if ((unsigned char)(head - MAX7219MultiTail) >= MAX7219_QUEUE_SIZE)
+      return 0;
+  } while (!__atomic_compare_exchange_n(&MAX7219MultiHead, &head, (unsigned char)(head + 1), 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+  *slot = head;
+  return 1;
+#endif
+}
@@ -0,0 +1,358 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_SCHED.C
+* Description: MAX7219 fixed-rate refresh scheduler with idle sleep
+*
+*  A hardware timer ticks at the rate given to MAX7219SchedInit().  The application registers its
+*  display work (animation steps, blinking, MAX7219ScrollTick(), MAX7219BufferTick(), ...) as tasks
+*  with MAX7219SchedAdd(), each with a period in ticks, and then only calls MAX7219SchedRun() in its
+*  main loop.  Every pass sleeps until the next tick, runs the tasks that are due and starts one
+*  flush of whatever they changed.  The display is updated at a fixed rate and the CPU is awake only
+*  for the work itself, instead of spinning in _delay_ms() or redrawing as fast as it can.
+*
+*  The tasks run in the main loop, not in the interrupt, so they may use the whole driver.  If they
+*  take longer than a tick, the ticks missed meanwhile still count towards their periods: a task that
+*  runs late keeps its next runs on the times it was first due.  A task never runs twice in one pass,
+*  so a period missed entirely is dropped rather than made up.
+*
+*  Timer and sleep per port:
+*    ATmega  Timer1 in CTC mode (clk / 64), SLEEP_MODE_IDLE.  F_CPU must be defined, as for
+*            <util/delay.h>.  Parts with a single TIMSK (ATmega8/16/32) are handled too.
+*    UC3L    TC0 channel MAX7219_SCHED_TC_CHANNEL (fPBA / 128), the SLEEP instruction in Idle mode.
+*            The application must have called INTC_init_interrupts() before MAX7219SchedInit().
+*    host    no timer: a pass that would sleep fires the next tick at once, so a host program runs
+*            one tick per MAX7219SchedRun() (see MAX7219_BENCH.C for the duty cycle this gives).
+*
+*  The scheduler installs the interrupt handler of its timer (ISR(TIMER1_COMPA_vect) on the ATmega).
+*  An application that needs that handler for its own work builds with -DMAX7219_SCHED_ISR=0 and
+*  calls MAX7219SchedTick() from its handler instead (on the UC3L after reading the TC status):
+*
+*    ISR(TIMER1_COMPA_vect) { MAX7219SchedTick(); MyTimerWork(); }
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+
+#if defined(__AVR32__)
+#include "compiler.h"                                 // Disable_global_interrupt(), SLEEP()
+#include "intc.h"
+#include "tc.h"
+#elif defined(__AVR__)
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#endif
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#if defined(__AVR32__)
+#ifndef MAX7219_SCHED_PBA_HZ
+#define MAX7219_SCHED_PBA_HZ      25000000UL          // main_32.c runs fPBA at 25 MHz
+#endif
+#ifndef MAX7219_SCHED_TC_CHANNEL
+#define MAX7219_SCHED_TC_CHANNEL  0
+#endif
+#define SCHED_TC          (&AVR32_TC0)
+#endif
+
+// Mask interrupts and give back the state the caller had, as MAX7219_QUEUE.C does.
+#if defined(__AVR32__)
+#define SCHED_LOCK(state)   do { (state) = Is_global_interrupt_enabled(); \
+                                 Disable_global_interrupt(); } while (0)
+#define SCHED_UNLOCK(state) do { if (state) Enable_global_interrupt(); } while (0)
+#elif defined(__AVR__)
+#define SCHED_LOCK(state)   do { (state) = SREG; cli(); } while (0)
+#define SCHED_UNLOCK(state) SREG = (state)
+#else
+#define SCHED_LOCK(state)   ((state) = 0)
+#define SCHED_UNLOCK(state) ((void)(state))
+#endif
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+struct max7219_task {
+  void (*run)(void);                                  // 0 = free slot
+  unsigned int period;                                // ticks between runs
+  unsigned int left;                                  // ticks until the next run
+};
+
+static struct max7219_task MAX7219Tasks[MAX7219_SCHED_TASKS];
+static volatile unsigned char MAX7219SchedPending;    // ticks counted by the timer, not handled yet
+static uint32_t MAX7219SchedNow;                      // ticks handled since MAX7219SchedInit()
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static unsigned char MAX7219SchedWait (void);
+static void MAX7219SchedTimerInit (unsigned int rate_hz);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219SchedInit()
+*
+* Description: Start the tick timer and enable interrupts.  Registered tasks are kept.
+* Arguments  : rate_hz = ticks per second (ATmega: at least F_CPU / 64 / 65536, UC3L: at least
+*                        fPBA / 128 / 65536)
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SchedInit (unsigned int rate_hz) {
+  MAX7219SchedPending = 0;
+  MAX7219SchedNow = 0;
+  MAX7219SchedTimerInit(rate_hz ? rate_hz : 1);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SchedAdd()
+*
+* Description: Register a task.  Its first run is one period from now.
+* Arguments  : task = function to run from MAX7219SchedRun()
+*              period = ticks between runs, at least 1
+* Returns    : 1 = registered, 0 = all MAX7219_SCHED_TASKS slots in use
+*********************************************************************************************************
+*/
+unsigned char MAX7219SchedAdd (void (*task)(void), unsigned int period) {
+  unsigned char i;
+
+  for (i = 0; i < MAX7219_SCHED_TASKS; i++)
+    if (MAX7219Tasks[i].run == 0) {
+      MAX7219Tasks[i].period = period ? period : 1;
+      MAX7219Tasks[i].left   = MAX7219Tasks[i].period;
+      MAX7219Tasks[i].run    = task;
+      return 1;
+    }
+  return 0;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SchedRemove()
+*
+* Description: Unregister a task; a task may remove itself.
+* Arguments  : task = function given to MAX7219SchedAdd()
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SchedRemove (void (*task)(void)) {
+  unsigned char i;
+
+  for (i = 0; i < MAX7219_SCHED_TASKS; i++)
+    if (MAX7219Tasks[i].run == task)
+      MAX7219Tasks[i].run = 0;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SchedRun()
+*
+* Description: One pass of the main loop: sleep until the next tick, run the tasks that are due and
+*              start a flush of what they changed.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SchedRun (void) {
+  struct max7219_task *task;
+  unsigned char ticks = MAX7219SchedWait();
+  unsigned char late;
+
+  MAX7219SchedNow += ticks;
+  for (task = MAX7219Tasks; task < MAX7219Tasks + MAX7219_SCHED_TASKS; task++) {
+    if (task->run == 0)
+      continue;
+    if (task->left > ticks) {
+      task->left -= ticks;
+      continue;
+    }
+    late = ticks - task->left;                        // ticks since the task was due
+    task->left = task->period;
+    if (late)                                         // overrun: stay on the grid of the first run,
+      task->left -= late % task->period;              // dropping whole periods that were missed
+    task->run();
+  }
+  MAX7219FlushAsync(0);                               // the bus runs while the CPU sleeps again
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SchedTick()
+*
+* Description: Count one timer tick.  Called by the scheduler's own timer interrupt, or with
+*              MAX7219_SCHED_ISR = 0 by the application's handler of that interrupt.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SchedTick (void) {
+  if (MAX7219SchedPending != 0xff)
+    MAX7219SchedPending++;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SchedTime()
+*
+* Description: Read the scheduler clock.
+* Arguments  : none
+* Returns    : ticks handled since MAX7219SchedInit()
+*********************************************************************************************************
+*/
+uint32_t MAX7219SchedTime (void) {
+  return MAX7219SchedNow;
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219SchedWait()
+*
+* Description: Sleep until at least one tick has been counted, then take the count.  The check and
+*              the sleep are atomic, so a tick that comes in between cannot be slept through.  The
+*              sleep itself needs interrupts; afterwards they are left as the caller had them.
+*********************************************************************************************************
+*/
+static unsigned char MAX7219SchedWait (void) {
+  unsigned char ticks, state;
+
+  SCHED_LOCK(state);
+  while (MAX7219SchedPending == 0) {
+#if defined(__AVR32__)
+    SLEEP(AVR32_PM_SMODE_GMCLEAR_MASK | AVR32_PM_SMODE_IDLE);  // unmasks interrupts as it sleeps
+    Disable_global_interrupt();
+#elif defined(__AVR__)
+    sleep_enable();
+    sei();
+    sleep_cpu();                                      // sei takes effect after this instruction
+    sleep_disable();
+    cli();
+#else
+    MAX7219SchedPending = 1;                          // host: the timer fires at once
+#endif
+  }
+  ticks = MAX7219SchedPending;
+  MAX7219SchedPending = 0;
+  SCHED_UNLOCK(state);
+  return ticks;
+}
+
+
+#if defined(__AVR32__)
+#if MAX7219_SCHED_ISR
+/*
+*********************************************************************************************************
+* MAX7219SchedTcIsr()
+*
+* Description: RC compare: count a tick.  Reading the status register clears the interrupt.
+*********************************************************************************************************
+*/
+__attribute__((__interrupt__))
+static void MAX7219SchedTcIsr (void) {
+  tc_read_sr(SCHED_TC, MAX7219_SCHED_TC_CHANNEL);
+  MAX7219SchedTick();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+* MAX7219SchedTimerInit()
+*
+* Description: Run TC0 up to RC and back at rate_hz, interrupting on every RC compare.
+*********************************************************************************************************
+*/
+static void MAX7219SchedTimerInit (unsigned int rate_hz) {
+  static const tc_waveform_opt_t waveform = {
+    .channel = MAX7219_SCHED_TC_CHANNEL,
+    .wavsel  = TC_WAVEFORM_SEL_UP_MODE_RC_TRIGGER,    // restart at RC
+    .tcclks  = TC_CLOCK_SOURCE_TC5                    // fPBA / 128
+  };
+  static const tc_interrupt_t interrupts = {
+    .cpcs = 1                                         // RC compare
+  };
+
+  Disable_global_interrupt();
+#if MAX7219_SCHED_ISR
+  INTC_register_interrupt(&MAX7219SchedTcIsr, AVR32_TC0_IRQ0 + MAX7219_SCHED_TC_CHANNEL, AVR32_INTC_INT0);
+#endif
+  tc_init_waveform(SCHED_TC, &waveform);
+  tc_write_rc(SCHED_TC, MAX7219_SCHED_TC_CHANNEL, (MAX7219_SCHED_PBA_HZ / 128) / rate_hz);
+  tc_configure_interrupts(SCHED_TC, MAX7219_SCHED_TC_CHANNEL, &interrupts);
+  tc_start(SCHED_TC, MAX7219_SCHED_TC_CHANNEL);
+  Enable_global_interrupt();
+}
+#elif defined(__AVR__)
+#if MAX7219_SCHED_ISR
+ISR(TIMER1_COMPA_vect) {
+  MAX7219SchedTick();
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+* MAX7219SchedTimerInit()
+*
+* Description: Run Timer1 in CTC mode at rate_hz and sleep in Idle, which keeps the timers, SPI and
+*              USART running.
+*********************************************************************************************************
+*/
+static void MAX7219SchedTimerInit (unsigned int rate_hz) {
+  cli();
+  TCCR1A = 0;
+  TCNT1  = 0;
+  OCR1A  = (uint16_t)(F_CPU / 64 / rate_hz - 1);
+  TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10);        // CTC, clk / 64
+#ifdef TIMSK1
+  TIMSK1 = _BV(OCIE1A);
+#else
+  TIMSK |= _BV(OCIE1A);                               // ATmega8/16/32: one mask for all timers
+#endif
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sei();
+}
+#else
+/*
+*********************************************************************************************************
+* MAX7219SchedTimerInit()
+*
+* Description: Host: nothing to start, MAX7219SchedWait() stands in for the timer.
+*********************************************************************************************************
+*/
+static void MAX7219SchedTimerInit (unsigned int rate_hz) {
+  (void)rate_hz;
+}
+#endif
@@ -0,0 +1,214 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_SCROLL.C
+* Description: MAX7219 scrolling text driven by a periodic tick (port independent)
+*
+*  MAX7219ScrollStart() converts the message to segment codes once.  From then on every step only
+*  copies a window of that stream into the digit registers of the shadow copy: a fixed number of
+*  register updates, no font lookups, no formatting.  The text enters from the right and leaves on
+*  the left.
+*
+*  MAX7219ScrollTick() only changes the shadow registers; sending them is left to the caller's next
+*  flush.  The easy way is to run it as a scheduler task, which flushes after every pass:
+*
+*    MAX7219SchedInit(1000);                          // 1 ms ticks
+*    MAX7219SchedAdd(MAX7219ScrollTick, 1);
+*    for (;;) MAX7219SchedRun();
+*
+*  MAX7219ScrollSetRate() sets how many ticks make one step.  Do not call the tick from an interrupt:
+*  a flush the main loop has under way would send a half-updated window, and on the bit-bang
+*  transports a flush started from the interrupt would cut into the frame being clocked out.
+*
+*  While a scroll runs it owns the display: the application should not write to the MAX7219 until
+*  MAX7219ScrollRunning() returns 0 or it has called MAX7219ScrollStop().  The window digits must be in
+*  no-decode mode (see MAX7219SetDecodeMask()).
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+#include "max7219_font.h"                             // 7-segment font table
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define SCROLL_DIGITS     8                           // digit registers per chip
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static uint8_t       MAX7219ScrollStream[MAX7219_SCROLL_MAX];  // segment codes of the message
+static unsigned char MAX7219ScrollLength;             // codes in the stream
+static unsigned char MAX7219ScrollDigit;              // first (leftmost) digit of the window
+static unsigned char MAX7219ScrollWidth;              // digits in the window
+static unsigned char MAX7219ScrollRepeat;             // start over after the text has left
+static unsigned int  MAX7219ScrollRate = 1;           // ticks per step
+static unsigned int  MAX7219ScrollTicks;              // ticks since the last step
+static unsigned int  MAX7219ScrollPos;                // step number, 0 = window still blank
+static volatile unsigned char MAX7219ScrollActive;    // a scroll is running
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void MAX7219ScrollShow (void);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219ScrollStart()
+*
+* Description: Convert a message to segment codes and start scrolling it through a window of digits.
+*              A '.' following a character lights that character's decimal dot.
+* Arguments  : digit = first (leftmost) digit of the window (1-8)
+*              width = number of digits in the window; cut at digit 8
+*              message = text to scroll
+*              repeat = 1 to scroll the message again and again, 0 to stop once it has left
+* Returns    : 1 = started, 0 = the message was cut to MAX7219_SCROLL_MAX characters, or nothing was
+*              started because the window has no digit within 1-8
+*********************************************************************************************************
+*/
+unsigned char MAX7219ScrollStart (char digit, char width, const char *message, unsigned char repeat) {
+  unsigned char length = 0;
+  char character;
+
+  MAX7219ScrollActive = 0;                            // keep the tick out while the stream changes
+  if (digit < 1 || digit > SCROLL_DIGITS || width < 1)
+    return 0;
+  if (width > SCROLL_DIGITS + 1 - digit)              // never into the control registers
+    width = SCROLL_DIGITS + 1 - digit;
+  while ((character = *message) != '\0' && length < MAX7219_SCROLL_MAX) {
+    message++;
+    MAX7219ScrollStream[length] = MAX7219FontGlyph(character);
+    if (*message == '.' && character != '.') {        // fold the dot into this character
+      MAX7219ScrollStream[length] |= SEG_DP;
+      message++;
+    }
+    length++;
+  }
+
+  MAX7219ScrollLength = length;
+  MAX7219ScrollDigit  = digit;
+  MAX7219ScrollWidth  = width;
+  MAX7219ScrollRepeat = repeat;
+  MAX7219ScrollTicks  = 0;
+  MAX7219ScrollPos    = 0;
+  MAX7219ScrollShow();
+  MAX7219ScrollActive = 1;
+  MAX7219FlushAsync(0);
+  return *message == '\0';
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219ScrollSetRate()
+*
+* Description: Set the scroll speed.
+* Arguments  : ticks = MAX7219ScrollTick() calls per step, at least 1
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219ScrollSetRate (unsigned int ticks) {
+  MAX7219ScrollRate = ticks ? ticks : 1;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219ScrollStop()
+*
+* Description: Stop scrolling; the window keeps what it shows.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219ScrollStop (void) {
+  MAX7219ScrollActive = 0;
+  while (MAX7219FlushBusy())                          // let the last step finish
+    ;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219ScrollRunning()
+*
+* Description: Poll the scroll.
+* Arguments  : none
+* Returns    : 1 while scrolling, 0 once the text has left the window (or after MAX7219ScrollStop())
+*********************************************************************************************************
+*/
+unsigned char MAX7219ScrollRunning (void) {
+  return MAX7219ScrollActive;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219ScrollTick()
+*
+* Description: Advance the scroll; call from the main loop or a scheduler task, not from an
+*              interrupt.  Every MAX7219ScrollSetRate() ticks the window moves one digit to the left
+*              in the shadow registers; the next MAX7219Flush() or MAX7219FlushAsync() sends them.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219ScrollTick (void) {
+  if (!MAX7219ScrollActive)
+    return;
+  if (++MAX7219ScrollTicks < MAX7219ScrollRate)
+    return;
+  MAX7219ScrollTicks = 0;
+
+  if (++MAX7219ScrollPos > (unsigned int)(MAX7219ScrollLength + MAX7219ScrollWidth)) {  // text has left
+    if (!MAX7219ScrollRepeat) {
+      MAX7219ScrollActive = 0;
+      return;
+    }
+    MAX7219ScrollPos = 1;
+  }
+  MAX7219ScrollShow();
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219ScrollShow()
+*
+* Description: Copy the window at the current step into the digit registers.  At step n the last
+*              window digit shows stream code n - 1, the ones to its left the codes before it.
+*********************************************************************************************************
+*/
+static void MAX7219ScrollShow (void) {
+  int index = (int)MAX7219ScrollPos - MAX7219ScrollWidth;  // stream code under the first window digit
+  unsigned char digit;
+
+  for (digit = MAX7219ScrollDigit; digit < MAX7219ScrollDigit + MAX7219ScrollWidth; digit++, index++)
+    MAX7219SetRegister(digit, (index >= 0 && index < MAX7219ScrollLength) ?
+                              MAX7219ScrollStream[index] : 0);
+}
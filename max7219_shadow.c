@@ -0,0 +1,550 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_SHADOW.C
+* Description: MAX7219 shadow registers (port independent)
+*
+*  Every register the driver touches is mirrored here.  The display functions only change the RAM
+*  copy and mark the register dirty; MAX7219Flush() then clocks out just the dirty registers.  A
+*  display loop that keeps redrawing the same content therefore costs no bus traffic at all.  A
+*  second copy holds what each chip last latched, so a register set back to that value before the
+*  flush is not dirty any more either.
+*
+*  With a daisy chain each chip has its own copy, and a flush packs one dirty register of every chip
+*  into each LOAD frame, so it takes as many frames as the busiest chip has dirty registers.  The
+*  direct writes in MAX7219_CHAIN.C report what they send through MAX7219ShadowUpdate(), so they keep
+*  the shadow copy in step with the chips.
+*
+*  The scan limit, intensity and shutdown values that MAX7219SetAutoPower() derives live in the shadow
+*  copy too, but reading those registers back returns what the application set.
+*
+*  MAX7219Begin()/MAX7219Commit() hold every flush back, and turn the direct writes into shadow
+*  updates, until the outermost commit: whatever the application does in between, each register goes
+*  out at most once, with its last value.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+#include "max7219_font.h"                             // CODEB_BLANK
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define SHADOW_REGS       16                          // one slot per register address 0x00-0x0f
+#define SHADOW_TRACKED    0x9ffe                      // digits 1-8, decode, intensity, scan, shutdown, test
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+static unsigned char MAX7219Shadow[MAX7219_CHAIN_MAX][SHADOW_REGS];  // last value written or queued
+static unsigned char MAX7219Latched[MAX7219_CHAIN_MAX][SHADOW_REGS];  // last value the chip latched
+static uint16_t      MAX7219Dirty[MAX7219_CHAIN_MAX]; // bit n set = register n differs from the chip
+static uint16_t      MAX7219Stale[MAX7219_CHAIN_MAX]; // bit n set = MAX7219Latched[][n] is not known
+static unsigned char MAX7219Frame[2 * MAX7219_CHAIN_MAX];  // frame being sent, farthest chip first
+static volatile unsigned char MAX7219AsyncBusy;       // asynchronous flush in progress
+static unsigned char MAX7219Transaction;              // nesting depth of MAX7219Begin()
+static void (*MAX7219AsyncDone)(void);                // called when the asynchronous flush ends
+static unsigned char MAX7219AutoModes = MAX7219_AUTO_POWER;  // MAX7219SetAutoPower() modes
+static unsigned char MAX7219WantScan[MAX7219_CHAIN_MAX];       // scan limit set by the application
+static unsigned char MAX7219WantAwake[MAX7219_CHAIN_MAX];      // shutdown register set by the application
+static unsigned char MAX7219WantIntensity[MAX7219_CHAIN_MAX];  // intensity set by the application
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void MAX7219ShadowSet (unsigned char chip, unsigned char reg_number, unsigned char data);
+static void MAX7219ShadowWant (unsigned char chip, unsigned char reg_number, unsigned char data);
+static void MAX7219AutoPower (void);
+static unsigned char MAX7219BuildFrame (void);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219SetRegister()
+*
+* Description: Update the shadow copy of a register of chip 0.  Nothing is sent until MAX7219Flush().
+* Arguments  : reg_number = register to update
+*              data = new register value
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SetRegister (unsigned char reg_number, unsigned char data) {
+  MAX7219SetRegisterChip(0, reg_number, data);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SetRegisterChip()
+*
+* Description: Update the shadow copy of a register of one chip in the chain.
+* Arguments  : chip = chip index (0 = nearest the MCU)
+*              reg_number = register to update
+*              data = new register value
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SetRegisterChip (unsigned char chip, unsigned char reg_number, unsigned char data) {
+  if (chip >= MAX7219_CHAIN_MAX)
+    return;
+  reg_number &= 0x0f;
+  if (MAX7219Shadow[chip][reg_number] == data)
+    MAX7219_STATS_SKIP();                             // nothing new for the chip
+  MAX7219ShadowWant(chip, reg_number, data);
+  MAX7219ShadowSet(chip, reg_number, data);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SetRegisterAll()
+*
+* Description: Update the same register of every chip in the chain.
+* Arguments  : reg_number = register to update
+*              data = new register value
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SetRegisterAll (unsigned char reg_number, unsigned char data) {
+  unsigned char chip;
+  for (chip = 0; chip < MAX7219GetChainLength(); chip++)
+    MAX7219SetRegisterChip(chip, reg_number, data);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219GetRegister()
+*
+* Description: Read back the shadow copy of a register of chip 0.
+* Arguments  : reg_number = register to read
+* Returns    : current (possibly not yet flushed) register value; for the scan limit, intensity and
+*              shutdown registers the value the application set, not the one MAX7219SetAutoPower()
+*              derives from it
+*********************************************************************************************************
+*/
+unsigned char MAX7219GetRegister (unsigned char reg_number) {
+  return MAX7219GetRegisterChip(0, reg_number);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219GetRegisterChip()
+*
+* Description: Read back the shadow copy of a register of one chip in the chain.
+* Arguments  : chip = chip index
+*              reg_number = register to read
+* Returns    : as MAX7219GetRegister(); 0 for a chip outside the chain
+*********************************************************************************************************
+*/
+unsigned char MAX7219GetRegisterChip (unsigned char chip, unsigned char reg_number) {
+  if (chip >= MAX7219_CHAIN_MAX)
+    return 0;
+  switch (reg_number &= 0x0f) {
+    case REG_SCAN_LIMIT: return MAX7219WantScan[chip];
+    case REG_SHUTDOWN:   return MAX7219WantAwake[chip];
+    case REG_INTENSITY:  return MAX7219GetWantedIntensity(chip);
+  }
+  return MAX7219Shadow[chip][reg_number];
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219GetWantedIntensity()
+*
+* Description: Read the intensity the application set for a chip, before MAX7219SetAutoPower()
+*              rescales it for the digits scanned.
+* Arguments  : chip = chip index
+* Returns    : intensity 0-15, 0 for a chip outside the chain
+*********************************************************************************************************
+*/
+unsigned char MAX7219GetWantedIntensity (unsigned char chip) {
+  if (chip >= MAX7219_CHAIN_MAX)
+    return 0;
+  return MAX7219WantIntensity[chip] & 0x0f;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219Flush()
+*
+* Description: Send every register whose shadow value has not reached the chips yet.  Each LOAD
+*              frame carries the next dirty register of every chip; chips with nothing left get a
+*              no-op.  Each chip gets its digits first and its control registers last, so it leaves
+*              shutdown fully configured.  Inside MAX7219Begin()/MAX7219Commit() nothing is sent.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219Flush (void) {
+  unsigned char len, i;
+
+  if (MAX7219Transaction)                             // MAX7219Commit() will send it
+    return;
+  MAX7219_STATS_START();
+  while (MAX7219AsyncBusy)                            // let a running asynchronous flush finish
+    ;
+  MAX7219AutoPower();
+  while ((len = MAX7219BuildFrame()) != 0) {
+    MAX7219FrameStart();
+    for (i = 0; i < len; i += 2)
+      MAX7219FrameWord(MAX7219Frame[i], MAX7219Frame[i + 1]);
+    MAX7219FrameLatch();
+  }
+  MAX7219_STATS_STOP(MAX7219_STATS_FLUSH);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FlushAsync()
+*
+* Description: Start sending the dirty registers in the background.
+* Arguments  : done = function called (from interrupt context) when the flush is complete, or 0
+* Returns    : 1 = flush started (or nothing to send, done() already called)
+*              0 = a flush is still running, or a transaction is open; registers changed so far go
+*                  out with it
+*********************************************************************************************************
+*/
+unsigned char MAX7219FlushAsync (void (*done)(void)) {
+  if (MAX7219AsyncBusy || MAX7219Transaction)         // only the interrupt clears busy, so no race
+    return 0;
+#if !MAX7219_TRANSPORT_IRQ
+  MAX7219Flush();                                     // no interrupt source to drive the pins
+  if (done)
+    done();
+#else
+  unsigned char len;
+  MAX7219AutoPower();
+  len = MAX7219BuildFrame();
+  if (len == 0) {
+    if (done)
+      done();
+    return 1;
+  }
+  MAX7219AsyncDone = done;
+  MAX7219AsyncBusy = 1;
+  MAX7219FrameSendAsync(MAX7219Frame, len);
+#endif
+  return 1;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219FlushBusy()
+*
+* Description: Poll an asynchronous flush.
+* Arguments  : none
+* Returns    : 1 while frames are still being sent, 0 when idle
+*********************************************************************************************************
+*/
+unsigned char MAX7219FlushBusy (void) {
+  return MAX7219AsyncBusy;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SetAutoPower()
+*
+* Description: Choose what the driver adjusts by itself on every flush, from what the digit registers
+*              show.  The scan limit, shutdown and intensity the application sets are kept as limits:
+*              MAX7219_AUTO_SCAN scans only up to the last lit digit (never fewer than
+*                MAX7219_AUTO_SCAN_MIN + 1 digits, never more than the application's scan limit) and
+*                lowers the intensity in proportion, so the display looks as bright on less current;
+*              MAX7219_AUTO_SHUTDOWN shuts a chip down while all its digits are blank.
+* Arguments  : modes = MAX7219_AUTO_SCAN and/or MAX7219_AUTO_SHUTDOWN, or 0 to leave the registers
+*                      exactly as the application sets them
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SetAutoPower (unsigned char modes) {
+  unsigned char chip;
+
+  MAX7219AutoModes = modes;
+  for (chip = 0; chip < MAX7219_CHAIN_MAX; chip++) {  // back to the application's values until the flush
+    MAX7219ShadowSet(chip, REG_SCAN_LIMIT, MAX7219WantScan[chip]);
+    MAX7219ShadowSet(chip, REG_SHUTDOWN, MAX7219WantAwake[chip]);
+    MAX7219ShadowSet(chip, REG_INTENSITY, MAX7219WantIntensity[chip]);
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219Begin()
+*
+* Description: Open a transaction.  Until the matching MAX7219Commit(), flushes are held back and
+*              MAX7219Write(), MAX7219WriteChip() and MAX7219WriteAll() only update the shadow copy,
+*              so repeated writes to a register collapse to the last one.  Transactions nest.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219Begin (void) {
+  MAX7219Transaction++;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219Commit()
+*
+* Description: Close a transaction.  The outermost commit sends every register that ends up different
+*              from what the chips hold, packed as tightly as MAX7219Flush() can.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219Commit (void) {
+  if (MAX7219Transaction && --MAX7219Transaction == 0)
+    MAX7219Flush();
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219InTransaction()
+*
+* Description: Tell whether a transaction is open.
+* Arguments  : none
+* Returns    : 1 between MAX7219Begin() and the outermost MAX7219Commit(), 0 otherwise
+*********************************************************************************************************
+*/
+unsigned char MAX7219InTransaction (void) {
+  return MAX7219Transaction != 0;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219Invalidate()
+*
+* Description: Mark all tracked registers of every chip dirty so the next flush resends everything,
+*              e.g. after the chips lost power.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219Invalidate (void) {
+  unsigned char chip;
+  for (chip = 0; chip < MAX7219_CHAIN_MAX; chip++)
+    MAX7219Dirty[chip] = MAX7219Stale[chip] = SHADOW_TRACKED;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219ShadowUpdate()
+*
+* Description: Record a word that has just been latched by a chip.  Called by the MAX7219_CHAIN.C
+*              write functions.
+* Arguments  : chip = chip index
+*              reg_number = register written
+*              data = value written
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219ShadowUpdate (unsigned char chip, unsigned char reg_number, unsigned char data) {
+  if (chip >= MAX7219_CHAIN_MAX)
+    return;
+  reg_number &= 0x0f;
+  MAX7219ShadowWant(chip, reg_number, data);
+  MAX7219Shadow[chip][reg_number] = MAX7219Latched[chip][reg_number] = data;
+  MAX7219Dirty[chip] &= ~(1U << reg_number);
+  MAX7219Stale[chip] &= ~(1U << reg_number);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219ShadowDeferrable()
+*
+* Description: Tell whether a register is tracked by the shadow copy, i.e. whether a direct write to
+*              it can be queued in a transaction instead of going out at once.
+* Arguments  : reg_number = register
+* Returns    : 1 = tracked, 0 = not (no-op and the unused addresses)
+*********************************************************************************************************
+*/
+unsigned char MAX7219ShadowDeferrable (unsigned char reg_number) {
+  return ((1U << (reg_number & 0x0f)) & SHADOW_TRACKED) != 0;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219AsyncFrameDone()
+*
+* Description: Called by the port's interrupt handler once a frame has been latched.  Starts the next
+*              frame or ends the asynchronous flush.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219AsyncFrameDone (void) {
+#if MAX7219_TRANSPORT_IRQ
+  unsigned char len = MAX7219BuildFrame();
+  if (len != 0) {
+    MAX7219FrameSendAsync(MAX7219Frame, len);
+    return;
+  }
+#endif
+  MAX7219AsyncBusy = 0;
+  if (MAX7219AsyncDone)
+    MAX7219AsyncDone();
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219ShadowSet()
+*
+* Description: Change the shadow copy of a register and work out whether it now differs from the chip.
+*********************************************************************************************************
+*/
+static void MAX7219ShadowSet (unsigned char chip, unsigned char reg_number, unsigned char data) {
+  uint16_t bit;
+
+  if (MAX7219Shadow[chip][reg_number] == data)        // already there (or already queued)
+    return;
+  MAX7219Shadow[chip][reg_number] = data;
+  bit = (1U << reg_number) & SHADOW_TRACKED;
+  if (MAX7219Latched[chip][reg_number] == data && !(MAX7219Stale[chip] & bit))
+    MAX7219Dirty[chip] &= ~bit;                       // changed back before it was sent
+  else
+    MAX7219Dirty[chip] |= bit;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219ShadowWant()
+*
+* Description: Remember the scan limit, shutdown and intensity values the application asks for;
+*              MAX7219AutoPower() derives the values actually sent from them.
+*********************************************************************************************************
+*/
+static void MAX7219ShadowWant (unsigned char chip, unsigned char reg_number, unsigned char data) {
+  switch (reg_number) {
+    case REG_SCAN_LIMIT: MAX7219WantScan[chip]      = data; break;
+    case REG_SHUTDOWN:   MAX7219WantAwake[chip]     = data; break;
+    case REG_INTENSITY:  MAX7219WantIntensity[chip] = data; break;
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219AutoPower()
+*
+* Description: Set scan limit, intensity and shutdown of every chip from its lit digits, as chosen with
+*              MAX7219SetAutoPower().  The LED duty cycle of a digit is (2 * intensity + 1) / 32 divided
+*              by the digits scanned, so the intensity is scaled by scanned / wanted digits.
+*********************************************************************************************************
+*/
+static void MAX7219AutoPower (void) {
+  unsigned char chip, reg, high, scan, awake, intensity, decode, wanted, on;
+
+  if (!MAX7219AutoModes)
+    return;
+  for (chip = 0; chip < MAX7219GetChainLength(); chip++) {
+    decode = MAX7219Shadow[chip][REG_DECODE];
+    for (high = 0, reg = REG_DIGIT0 + 7; reg >= REG_DIGIT0 && !high; reg--) {
+      if (decode & (1 << (reg - REG_DIGIT0)))         // code B: 0x0f is blank, bits 4-6 unused
+        on = (MAX7219Shadow[chip][reg] & 0x8f) != CODEB_BLANK;
+      else
+        on = MAX7219Shadow[chip][reg] != 0;
+      if (on)
+        high = reg;                                   // last lit digit, 1-8
+    }
+
+    scan      = MAX7219WantScan[chip] & 0x07;
+    awake     = MAX7219WantAwake[chip];
+    intensity = MAX7219WantIntensity[chip] & 0x0f;
+    if ((MAX7219AutoModes & MAX7219_AUTO_SCAN) && high) {
+      wanted = scan;
+      if (high - 1 < scan) {
+        scan = high - 1;
+        if (scan < MAX7219_AUTO_SCAN_MIN)
+          scan = (MAX7219_AUTO_SCAN_MIN < wanted) ? MAX7219_AUTO_SCAN_MIN : wanted;
+      }
+      // duty (2i + 1) / 32 / (scan + 1) kept: 2i' + 1 = (2i + 1) * (scan + 1) / (wanted + 1), rounded
+      intensity = ((2 * intensity + 1) * (scan + 1) + (wanted + 1) / 2) / (wanted + 1);
+      intensity = intensity ? (intensity - 1) / 2 : 0;
+    }
+    if ((MAX7219AutoModes & MAX7219_AUTO_SHUTDOWN) && !high)
+      awake = 0;                                      // nothing to show: save the current
+
+    MAX7219ShadowSet(chip, REG_SCAN_LIMIT, scan);
+    MAX7219ShadowSet(chip, REG_INTENSITY, intensity);
+    MAX7219ShadowSet(chip, REG_SHUTDOWN, awake);
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219BuildFrame()
+*
+* Description: Build the next frame for the whole chain in MAX7219Frame[]: for each chip the lowest of
+*              its dirty registers, a no-op for chips with none.  Safe against MAX7219SetRegisterChip()
+*              from the main loop: a value changed under it is at worst sent twice, never lost.
+* Arguments  : none
+* Returns    : frame length in bytes, 0 when nothing is dirty
+*********************************************************************************************************
+*/
+static unsigned char MAX7219BuildFrame (void) {
+  unsigned char length = MAX7219GetChainLength();
+  unsigned char *p = MAX7219Frame;
+  unsigned char chip, reg, any = 0;
+  uint16_t dirty, bit;
+
+  for (chip = length; chip-- > 0; ) {                 // farthest chip first
+    dirty = MAX7219Dirty[chip];
+    if (dirty) {
+      for (reg = REG_DIGIT0, bit = 1U << REG_DIGIT0; !(dirty & bit); reg++, bit <<= 1)
+        ;
+      MAX7219Dirty[chip] &= ~bit;
+      MAX7219Stale[chip] &= ~bit;
+      *p++ = reg;
+      *p++ = MAX7219Latched[chip][reg] = MAX7219Shadow[chip][reg];
+      MAX7219_STATS_WORD(chip, reg, p[-1]);
+      any = 1;
+    } else {
+      *p++ = REG_NOOP;
+      *p++ = 0;
+    }
+  }
+  if (!any)
+    return 0;
+  MAX7219_STATS_FRAME(p - MAX7219Frame);
+  return p - MAX7219Frame;
+}
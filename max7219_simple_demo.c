@@ -4,7 +4,8 @@
 * Description: MAX7219 LED demo.
 *              This demo display all segments and dots of the LED.  It will display
 *              first at dim level for 2 seconds then at brighter level for 2 seconds
-*              and loops back.
+*              and loops back, fading over 1 second in between.  The MCU sleeps between
+*              the ticks of MAX7219_SCHED.C.
 *
 * DISCLAIMER:
 * -No warranty or whatsoever.  This is a sample/demo.
@@ -22,10 +23,36 @@
 *********************************************************************************************************
 */
 #include <avr/io.h>                                   // microcontroller header file
-#include <util/delay.h>
 #include <avr/interrupt.h>
 #include "max7219.h"                                  // MAX7219 header file
 
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define DEMO_TICK_HZ      50                          // scheduler ticks per second
+
+
+/*
+*********************************************************************************************************
+* demoBlink()
+*
+* Description: Fade between brightness 3 and 15; runs every 2 seconds.
+* Arguments  : None
+* Returns    : none
+*********************************************************************************************************
+*/
+static void demoBlink (void) {
+  static const uint8_t brightness_levels[2] = {3,15};
+  static uint8_t index = 0;
+
+  index = index ^ 1;
+  MAX7219Fade(brightness_levels[index], DEMO_TICK_HZ);
+}
+
+
 /*
 *********************************************************************************************************
 * intrInit() 
@@ -67,24 +94,20 @@ int main(void) {
   ioInit();
   intrInit();
 
-  // 4 digits + the ':' on the display.
-  MAX7219Write(REG_SCAN_LIMIT, 5);       // 5 digit scan
-
-  // Loop forever and display all segments with brightness of
-  // 3 and 15 alternatively.
-  uint8_t brightness_levels[2] = {3,15};
-  uint8_t index = 0;
-  while (1) {
-    // No button pressed.  Light up everything on the display.
-    index = index ^ 1;
-    MAX7219SetBrightness(brightness_levels[index]);
-    MAX7219DisplayChar(1, '8', 0x80);
-    MAX7219DisplayChar(2, '8', 0x80);
-    MAX7219DisplayL123(L1 | L2 | L3);
-    MAX7219DisplayChar(4, '8', 0x80);
-    MAX7219DisplayChar(5, '8', 0x80);
-    _delay_ms(2000);
-  }
+  // 4 digits + the ':' on the display; auto power scans only those five.
+  // Light up everything on the display once; from then on only the
+  // brightness changes, every 2 seconds, between 3 and 15 alternatively.
+  MAX7219DisplayChar(1, '8', 0x80);
+  MAX7219DisplayChar(2, '8', 0x80);
+  MAX7219DisplayL123(L1 | L2 | L3);
+  MAX7219DisplayChar(4, '8', 0x80);
+  MAX7219DisplayChar(5, '8', 0x80);
+  MAX7219Fade(3, 0);
+  MAX7219SchedAdd(demoBlink, 2 * DEMO_TICK_HZ);
+  MAX7219SchedAdd(MAX7219FadeTick, 1);
+  MAX7219SchedInit(DEMO_TICK_HZ);
 
+  while (1)
+    MAX7219SchedRun();                   // sleeps until the next tick, sends only changes
   return 0;
 }
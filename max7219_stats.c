@@ -0,0 +1,318 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_STATS.C
+* Description: MAX7219 bus traffic counters and write trace (optional, port independent)
+*
+*  Compiled in only with MAX7219_STATS = 1 and/or MAX7219_TRACE_SIZE > 0 (e.g. -DMAX7219_STATS=1
+*  -DMAX7219_TRACE_SIZE=16); otherwise this module is empty and the hooks in MAX7219_SHADOW.C and
+*  MAX7219_CHAIN.C expand to nothing, so a release build carries no code or data for it.
+*
+*  The counters see every frame the driver sends, whether it comes from MAX7219Flush(), an
+*  asynchronous flush or a direct write:
+*
+*    writes, frames, bits  register words (no-ops not counted), LOAD pulses and bits clocked out;
+*    skipped               MAX7219SetRegisterChip() calls that left a register as it was, i.e. bus
+*                          traffic the shadow copy saved;
+*    bytes_per_sec         bytes clocked out between the last two MAX7219StatsSecond() calls: run it
+*                          once a second, e.g. MAX7219SchedAdd(MAX7219StatsSecond, rate_hz);
+*    write_max, flush_max  the longest a direct write or MAX7219Flush() kept its caller waiting,
+*                          including the wait for a running asynchronous flush.
+*
+*  Blocking time is read from a clock per port:
+*    ATmega  Timer1 (TCNT1).  With the scheduler running it counts clk / 64 and wraps at OCR1A, which
+*            is allowed for; otherwise the application must start Timer1.  Times longer than one
+*            timer period are not measured correctly.
+*    UC3L    the COUNT system register, i.e. CPU cycles.
+*    host    clock_gettime(), in nanoseconds.
+*  A board with a better clock defines MAX7219_STATS_CLOCK() to return a free-running 32-bit count.
+*
+*  The trace ring keeps the last MAX7219_TRACE_SIZE register words sent, with the chip they went to;
+*  MAX7219TraceGet() reads them back, newest first.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+
+#if MAX7219_STATS || MAX7219_TRACE_SIZE
+#if defined(__AVR32__)
+#include "compiler.h"                                 // Get_system_register(), interrupt masking
+#elif defined(__AVR__)
+#include <avr/io.h>                                   // TCNT1, SREG
+#include <avr/interrupt.h>
+#elif !defined(MAX7219_STATS_CLOCK)
+#include <time.h>                                     // clock_gettime()
+#endif
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#if (MAX7219_TRACE_SIZE & (MAX7219_TRACE_SIZE - 1)) || MAX7219_TRACE_SIZE > 128
+#error "MAX7219_TRACE_SIZE must be a power of two, at most 128"
+#endif
+
+#if defined(__AVR32__)
+#define STATS_LOCK()      unsigned char enabled = Is_global_interrupt_enabled(); \
+                          Disable_global_interrupt()
+#define STATS_UNLOCK()    if (enabled) Enable_global_interrupt()
+#elif defined(__AVR__)
+#define STATS_LOCK()      uint8_t sreg = SREG; cli()
+#define STATS_UNLOCK()    SREG = sreg
+#else
+#define STATS_LOCK()
+#define STATS_UNLOCK()
+#endif
+
+/*
+*********************************************************************************************************
+* Private Data
+*********************************************************************************************************
+*/
+#if MAX7219_STATS
+static struct max7219_stats MAX7219Stats;             // counters since MAX7219StatsReset()
+static uint32_t MAX7219StatsLastBits;                 // bits at the last MAX7219StatsSecond()
+#endif
+#if MAX7219_TRACE_SIZE
+static struct max7219_trace MAX7219Trace[MAX7219_TRACE_SIZE];  // last words sent
+static unsigned char MAX7219TraceHead;                // next entry to write
+static unsigned char MAX7219TraceCount;               // entries written, up to MAX7219_TRACE_SIZE
+#endif
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+#if MAX7219_STATS
+static uint32_t MAX7219StatsElapsed (uint32_t start);
+#endif
+
+
+// ...................................... Public Functions ..............................................
+
+
+#if MAX7219_STATS
+/*
+*********************************************************************************************************
+* MAX7219StatsGet()
+*
+* Description: Copy the counters, consistently even while an asynchronous flush adds to them.
+* Arguments  : stats = receives the counters
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219StatsGet (struct max7219_stats *stats) {
+  STATS_LOCK();
+  *stats = MAX7219Stats;
+  STATS_UNLOCK();
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219StatsReset()
+*
+* Description: Set every counter, the worst-case times and bytes_per_sec back to zero.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219StatsReset (void) {
+  STATS_LOCK();
+  MAX7219Stats.writes        = 0;
+  MAX7219Stats.skipped       = 0;
+  MAX7219Stats.frames        = 0;
+  MAX7219Stats.bits          = 0;
+  MAX7219Stats.bytes_per_sec = 0;
+  MAX7219Stats.write_max     = 0;
+  MAX7219Stats.flush_max     = 0;
+  MAX7219StatsLastBits       = 0;
+  STATS_UNLOCK();
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219StatsSecond()
+*
+* Description: Close a one-second period: bytes_per_sec becomes the bytes clocked out since the last
+*              call.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219StatsSecond (void) {
+  STATS_LOCK();
+  MAX7219Stats.bytes_per_sec = (MAX7219Stats.bits - MAX7219StatsLastBits) >> 3;
+  MAX7219StatsLastBits = MAX7219Stats.bits;
+  STATS_UNLOCK();
+}
+#endif
+
+
+#if MAX7219_TRACE_SIZE
+/*
+*********************************************************************************************************
+* MAX7219TraceGet()
+*
+* Description: Read a word from the trace ring.
+* Arguments  : age = 0 for the word sent last, 1 for the one before, ...
+*              entry = receives the word
+* Returns    : 1 = entry filled, 0 = fewer than age + 1 words recorded
+*********************************************************************************************************
+*/
+unsigned char MAX7219TraceGet (unsigned char age, struct max7219_trace *entry) {
+  unsigned char found = 0;
+
+  STATS_LOCK();
+  if (age < MAX7219TraceCount) {
+    *entry = MAX7219Trace[(unsigned char)(MAX7219TraceHead - 1 - age) & (MAX7219_TRACE_SIZE - 1)];
+    found = 1;
+  }
+  STATS_UNLOCK();
+  return found;
+}
+#endif
+
+
+/*
+*********************************************************************************************************
+* MAX7219StatsWord()
+*
+* Description: Count a register word and record it in the trace.  Called for every word the driver
+*              sends, from interrupt context during an asynchronous flush.
+* Arguments  : chip = chip index
+*              reg_number = register written
+*              data = value written
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219StatsWord (unsigned char chip, unsigned char reg_number, unsigned char data) {
+#if MAX7219_STATS
+  if (reg_number != REG_NOOP)
+    MAX7219Stats.writes++;
+#endif
+#if MAX7219_TRACE_SIZE
+  struct max7219_trace *entry = &MAX7219Trace[MAX7219TraceHead & (MAX7219_TRACE_SIZE - 1)];
+  entry->chip       = chip;
+  entry->reg_number = reg_number;
+  entry->data       = data;
+  MAX7219TraceHead++;
+  if (MAX7219TraceCount < MAX7219_TRACE_SIZE)
+    MAX7219TraceCount++;
+#else
+  (void)chip;
+  (void)data;
+#endif
+}
+
+
+#if MAX7219_STATS
+/*
+*********************************************************************************************************
+* MAX7219StatsFrame()
+*
+* Description: Count a LOAD frame.
+* Arguments  : bytes = bytes shifted out for it, two per chip
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219StatsFrame (unsigned char bytes) {
+  MAX7219Stats.frames++;
+  MAX7219Stats.bits += 8U * bytes;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219StatsSkip()
+*
+* Description: Count a register update that changed nothing.
+* Arguments  : none
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219StatsSkip (void) {
+  MAX7219Stats.skipped++;
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219StatsStart()
+*
+* Description: Read the clock at the start of a blocking call.
+* Arguments  : none
+* Returns    : clock count, for MAX7219StatsStop()
+*********************************************************************************************************
+*/
+uint32_t MAX7219StatsStart (void) {
+#if defined(MAX7219_STATS_CLOCK)
+  return MAX7219_STATS_CLOCK();
+#elif defined(__AVR32__)
+  return Get_system_register(AVR32_COUNT);
+#elif defined(__AVR__)
+  return TCNT1;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)now.tv_sec * 1000000000UL + (uint32_t)now.tv_nsec;
+#endif
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219StatsStop()
+*
+* Description: Read the clock at the end of a blocking call and keep the longest time.
+* Arguments  : start = MAX7219StatsStart() at the start of the call
+*              which = MAX7219_STATS_WRITE or MAX7219_STATS_FLUSH
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219StatsStop (uint32_t start, unsigned char which) {
+  uint32_t elapsed = MAX7219StatsElapsed(start);
+  uint32_t *worst = (which == MAX7219_STATS_FLUSH) ? &MAX7219Stats.flush_max : &MAX7219Stats.write_max;
+
+  if (elapsed > *worst)
+    *worst = elapsed;
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219StatsElapsed()
+*
+* Description: Clock counts since start.  The ATmega's Timer1 wraps at OCR1A in CTC mode (the
+*              scheduler) and at 0xffff otherwise.
+*********************************************************************************************************
+*/
+static uint32_t MAX7219StatsElapsed (uint32_t start) {
+  uint32_t now = MAX7219StatsStart();
+
+#if defined(__AVR__) && !defined(__AVR32__) && !defined(MAX7219_STATS_CLOCK)
+  if (now < start)
+    now += (TCCR1B & _BV(WGM12)) ? OCR1A + 1UL : 0x10000UL;
+#endif
+  return now - start;
+}
+#endif
+#endif
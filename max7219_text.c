@@ -0,0 +1,285 @@
+/*
+*********************************************************************************************************
+* Module     : MAX7219_TEXT.C
+* Description: MAX7219 string and number rendering (port independent)
+*
+*  Each call renders a whole field of digits into the shadow registers in one pass; MAX7219Flush()
+*  then sends only the digits that changed.  A field is given by its first digit and its width, so
+*  several fields can share one display.
+*
+*  Numbers are converted to BCD by shift-and-add-3 ("double dabble"): 32 shifts of a 5-byte buffer
+*  instead of ten 32-bit divisions, which the ATmega has to do in software.
+*
+* DISCLAIMER:
+* -No warranty or whatsoever.  This is a sample/demo.
+* -The author holds no responsibility of any sort of damage not limited to physically, emotionally, mentally,
+*  medically, finanically, or property-wise.  In other words, use at your own risks and your own
+*  liability.
+* -Do not use this sample commercially.
+*********************************************************************************************************
+*/
+
+
+/*
+*********************************************************************************************************
+* Include Header Files
+*********************************************************************************************************
+*/
+#include "max7219.h"                                  // MAX7219 header file
+#include "max7219_font.h"                             // 7-segment font table
+
+
+/*
+*********************************************************************************************************
+* Constants
+*********************************************************************************************************
+*/
+#define TEXT_DIGITS       8                           // digit registers per chip
+#define BCD_BYTES         5                           // 10 packed BCD digits hold any uint32_t
+
+/*
+*********************************************************************************************************
+* Private Function Prototypes
+*********************************************************************************************************
+*/
+static void MAX7219ToBcd (uint32_t value, uint8_t *bcd);
+static uint8_t MAX7219BcdDigit (const uint8_t *bcd, unsigned char n);
+static void MAX7219DisplayDecimal (char digit, char width, int32_t value, char decimals);
+
+
+// ...................................... Public Functions ..............................................
+
+
+/*
+*********************************************************************************************************
+* MAX7219DisplayString()
+*
+* Description: Display a string starting at a digit.  A '.' following a character lights that digit's
+*              decimal dot instead of taking a digit of its own.
+* Arguments  : digit = first digit (1-8)
+*              string = characters to display; stops at the end of the string or after digit 8
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219DisplayString (char digit, const char *string) {
+  char character;
+  uint8_t dot;
+
+  while ((character = *string++) != '\0' && digit <= TEXT_DIGITS) {
+    dot = 0;
+    if (*string == '.' && character != '.') {         // fold the dot into this digit
+      dot = SEG_DP;
+      string++;
+    }
+    MAX7219DisplayChar(digit++, character, dot);
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219DisplayInt()
+*
+* Description: Display a signed integer right aligned in a field, blank padded.
+* Arguments  : digit = first (leftmost) digit of the field (1-8)
+*              width = number of digits in the field
+*              value = number to display; a field too narrow for it shows all dashes
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219DisplayInt (char digit, char width, int32_t value) {
+  MAX7219DisplayDecimal(digit, width, value, 0);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219DisplayFixed()
+*
+* Description: Display a fixed-point number right aligned in a field, e.g. value = 1234, decimals = 2
+*              shows "12.34".  At least one digit is shown before the dot.
+* Arguments  : digit = first (leftmost) digit of the field (1-8)
+*              width = number of digits in the field
+*              value = number to display, scaled by 10^decimals
+*              decimals = digits after the decimal dot
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219DisplayFixed (char digit, char width, int32_t value, char decimals) {
+  MAX7219DisplayDecimal(digit, width, value, decimals);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219DisplayHex()
+*
+* Description: Display the low width nibbles of a value in hexadecimal, zero padded.  Nothing is shown
+*              for a first digit outside 1-8.
+* Arguments  : digit = first (leftmost) digit of the field (1-8)
+*              width = number of digits in the field
+*              value = number to display
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219DisplayHex (char digit, char width, uint32_t value) {
+  static const char hex[16] = {'0', '1', '2', '3', '4', '5', '6', '7',
+                               '8', '9', 'A', 'b', 'C', 'd', 'E', 'F'};
+  int pos;                                            // int: digit + width may pass 127
+
+  if (digit < 1 || digit > TEXT_DIGITS)
+    return;
+  for (pos = digit + width - 1; pos >= digit; pos--) {  // least significant nibble on the right
+    if (pos <= TEXT_DIGITS)
+      MAX7219DisplayChar(pos, hex[value & 0x0f], 0);
+    value >>= 4;
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219DisplayTime()
+*
+* Description: Display hh:mm.  Hours go to digits MAX7219_TIME_HOURS and MAX7219_TIME_HOURS + 1,
+*              minutes to MAX7219_TIME_MINUTES and MAX7219_TIME_MINUTES + 1, and the colon is drawn
+*              with MAX7219DisplayL123().
+* Arguments  : hours = 0-99
+*              minutes = 0-99
+*              colon = 1 to light the colon, 0 to leave it dark (e.g. to blink it)
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219DisplayTime (unsigned char hours, unsigned char minutes, unsigned char colon) {
+  uint8_t bcd[BCD_BYTES];
+
+  MAX7219ToBcd(hours, bcd);
+  MAX7219DisplayChar(MAX7219_TIME_HOURS,       '0' + (bcd[0] >> 4), 0);
+  MAX7219DisplayChar(MAX7219_TIME_HOURS + 1,   '0' + (bcd[0] & 0x0f), 0);
+  MAX7219ToBcd(minutes, bcd);
+  MAX7219DisplayChar(MAX7219_TIME_MINUTES,     '0' + (bcd[0] >> 4), 0);
+  MAX7219DisplayChar(MAX7219_TIME_MINUTES + 1, '0' + (bcd[0] & 0x0f), 0);
+  MAX7219DisplayL123(colon ? L_COLON : 0);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219SetDecodeMask()
+*
+* Description: Choose which digits of chip 0 the chip decodes itself (Code-B) and which take raw
+*              segments.  Digits that change mode are blanked, since their old contents would read
+*              differently in the new mode.
+* Arguments  : mask = bit n set = digit n + 1 in Code-B mode; 0x00 = all raw segments (the default)
+* Returns    : none
+*********************************************************************************************************
+*/
+void MAX7219SetDecodeMask (uint8_t mask) {
+  uint8_t changed = MAX7219GetRegister(REG_DECODE) ^ mask;
+  char digit;
+
+  MAX7219SetRegister(REG_DECODE, mask);
+  for (digit = 1; digit <= TEXT_DIGITS; digit++, changed >>= 1, mask >>= 1) {
+    if (changed & 1)
+      MAX7219SetRegister(digit, (mask & 1) ? CODEB_BLANK : 0);
+  }
+}
+
+
+// ..................................... Private Functions ..............................................
+
+/*
+*********************************************************************************************************
+* MAX7219ToBcd()
+*
+* Description: Convert a binary number to packed BCD by shift-and-add-3.  Leading zero bits are
+*              skipped, so small numbers take only as many rounds as they have significant bits.
+* Arguments  : value = number to convert
+*              bcd = BCD_BYTES bytes, least significant digit pair first
+* Returns    : none
+*********************************************************************************************************
+*/
+static void MAX7219ToBcd (uint32_t value, uint8_t *bcd) {
+  unsigned char bits, i;
+  uint8_t carry, next;
+
+  for (i = 0; i < BCD_BYTES; i++)
+    bcd[i] = 0;
+  for (bits = 32; bits > 0 && !(value & 0x80000000UL); bits--)
+    value <<= 1;
+
+  for (; bits > 0; bits--) {
+    carry = (value & 0x80000000UL) != 0;
+    value <<= 1;
+    for (i = 0; i < BCD_BYTES; i++) {
+      if ((bcd[i] & 0x0f) >= 0x05)                    // a digit >= 5 would pass 9 when doubled
+        bcd[i] += 0x03;
+      if ((bcd[i] & 0xf0) >= 0x50)
+        bcd[i] += 0x30;
+      next = bcd[i] >> 7;
+      bcd[i] = (bcd[i] << 1) | carry;
+      carry = next;
+    }
+  }
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219BcdDigit()
+*
+* Description: Read one digit of a packed BCD number.
+* Arguments  : bcd = number from MAX7219ToBcd()
+*              n = digit index, 0 = units
+* Returns    : 0-9
+*********************************************************************************************************
+*/
+static uint8_t MAX7219BcdDigit (const uint8_t *bcd, unsigned char n) {
+  uint8_t pair = bcd[n >> 1];
+  return (n & 1) ? (pair >> 4) : (pair & 0x0f);
+}
+
+
+/*
+*********************************************************************************************************
+* MAX7219DisplayDecimal()
+*
+* Description: Common part of MAX7219DisplayInt() and MAX7219DisplayFixed().  Nothing is shown for a
+*              first digit outside 1-8.
+* Arguments  : see MAX7219DisplayFixed()
+* Returns    : none
+*********************************************************************************************************
+*/
+static void MAX7219DisplayDecimal (char digit, char width, int32_t value, char decimals) {
+  uint8_t bcd[BCD_BYTES];
+  unsigned char negative = value < 0;
+  unsigned char used, n;
+  int pos;                                            // int: digit + width may pass 127
+
+  if (digit < 1 || digit > TEXT_DIGITS)
+    return;
+  MAX7219ToBcd(negative ? -(uint32_t)value : (uint32_t)value, bcd);
+  for (used = 2 * BCD_BYTES; used > 1 && MAX7219BcdDigit(bcd, used - 1) == 0; used--)
+    ;                                                 // significant digits, at least one
+  if (used <= (unsigned char)decimals)
+    used = decimals + 1;                              // "0.05", not ".05"
+
+  if (used + negative > (unsigned char)width) {       // does not fit: show an overflow
+    for (pos = digit; pos < digit + width && pos <= TEXT_DIGITS; pos++)
+      MAX7219DisplayChar(pos, '-', 0);
+    return;
+  }
+
+  n = 0;
+  for (pos = digit + width - 1; pos >= digit; pos--, n++) {  // right to left
+    if (pos > TEXT_DIGITS)
+      continue;
+    if (n < used)
+      MAX7219DisplayChar(pos, '0' + MAX7219BcdDigit(bcd, n),
+                         (decimals != 0 && n == (unsigned char)decimals) ? SEG_DP : 0);
+    else if (n == used && negative)
+      MAX7219DisplayChar(pos, '-', 0);
+    else
+      MAX7219DisplayChar(pos, ' ', 0);
+  }
+}